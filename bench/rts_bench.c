@@ -0,0 +1,521 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_bench.c
+ * @brief Benchmarks for the simulation hot paths.
+ *
+ * Every case runs in a child process, so its peak RSS is its own, and
+ * prints one CSV row to stdout:
+ *   - sim:   rts_sim_run()/rts_sim_run_event() for each registered
+ *            scheduler, ready queue backend, task count and hyperperiod
+ *   - rq:    insert every job, then select and remove them in order
+ *   - pool:  job allocation and release through the slab pool
+ *   - parse: rts_parser_load_tasks() on a generated task file, as text
+ *            (parse) and in the binary format (parse-bin)
+ *
+ * With --generic, sim and rq also time every built-in policy through the
+ * generic higher_prio() call ("EDF-fp" etc.) instead of its specialized
+ * queue copy.
+ *
+ * Task sets come from the generator with a fixed seed, so rows are
+ * comparable across builds.  Simulations run without log or trace, so
+ * only the engine is measured.  Progress goes to stderr.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "rts_gen.h"
+#include "rts_job_pool.h"
+#include "rts_parser.h"
+#include "rts_rq.h"
+#include "rts_sched.h"
+#include "rts_sim.h"
+#include "rts_types.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Repeat a case until it has run at least this long */
+#define BENCH_MIN_SEC 0.2
+
+/* Seed of every generated task set */
+#define BENCH_SEED 42
+
+/**
+ * struct bench_shape - a generated workload
+ * @name:    label in the output ("small" or "large" hyperperiod)
+ * @periods: enum rts_gen_periods
+ * @tmin:    smallest period
+ * @tmax:    largest period; the hyperperiod with these period sets
+ *
+ * The generator raises tmin to 2n/U for whole-unit WCETs, so @tmin grows
+ * to three times the task count here first, which keeps the ratio of
+ * harmonic periods.
+ */
+struct bench_shape {
+	const char *name;
+	int periods;
+	int tmin;
+	int tmax;
+};
+
+static const struct bench_shape bench_shapes[] = {
+	{ "small", RTS_GEN_HARMONIC, 10, 1280 },
+	{ "large", RTS_GEN_DIVISOR, 100, 720720 },
+};
+
+static const int bench_sizes[] = { 10, 100, 1000 };
+static const int bench_sizes_quick[] = { 10, 100 };
+
+/**
+ * struct bench_case - one row of the report
+ * @bench:  "sim", "rq", "pool", "parse" or "parse-bin"
+ * @sched:  scheduler (NULL: not applicable)
+ * @rq_ops: ready queue backend (NULL: not applicable)
+ * @engine: enum rts_engine, or -1
+ * @shape:  workload (NULL: not applicable)
+ * @n:      task count, or queued jobs for rq and pool
+ */
+struct bench_case {
+	const char *bench;
+	const struct rts_sched_class *sched;
+	const struct rts_rq_ops *rq_ops;
+	int engine;
+	const struct bench_shape *shape;
+	int n;
+};
+
+/**
+ * struct bench_result - what one case measured
+ * @iters:   repetitions timed
+ * @sec:     total wall time of those repetitions
+ * @horizon: simulated time units per repetition (sim only)
+ * @jobs:    jobs released per repetition (sim only)
+ * @ops:     operations per repetition (rq, pool, parse)
+ */
+struct bench_result {
+	long iters;
+	double sec;
+	rts_time_t horizon;
+	long jobs;
+	long ops;
+};
+
+static double bench_min_sec = BENCH_MIN_SEC;
+
+static double bench_now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static struct rts_task *bench_tasks(const struct bench_shape *shape, int n) {
+	struct rts_gen_opts opts;
+	int n_tasks;
+
+	rts_gen_defaults(&opts);
+	opts.n_tasks = n;
+	opts.util = 0.9;
+	opts.periods = shape->periods;
+	opts.tmin = shape->tmin > 3 * n ? shape->tmin : 3 * n;
+	opts.tmax = shape->periods == RTS_GEN_HARMONIC ?
+	            shape->tmax / shape->tmin * opts.tmin : shape->tmax;
+	opts.seed = BENCH_SEED;
+	return rts_gen_tasks(&opts, &n_tasks);
+}
+
+static int bench_sim(const struct bench_case *c, struct bench_result *r) {
+	struct rts_task *orig = bench_tasks(c->shape, c->n);
+	struct rts_task *tasks = malloc(sizeof(*tasks) * (size_t)c->n);
+	rts_time_t lcm, max_phase;
+
+	if (!orig || !tasks || rts_sim_horizon(orig, c->n, &lcm, &max_phase, 0) != 0) {
+		free(tasks);
+		free(orig);
+		return -1;
+	}
+
+	double t0 = bench_now();
+	do {
+		/* Runs advance the release state, so start every run afresh */
+		memcpy(tasks, orig, sizeof(*tasks) * (size_t)c->n);
+
+		struct rts_sim sim = {
+		    .tasks = tasks,
+		    .n_tasks = c->n,
+		    .rq_ops = c->rq_ops,
+		};
+
+		if (c->engine == RTS_ENGINE_EVENT)
+			rts_sim_run_event(&sim, c->sched, lcm, max_phase);
+		else
+			rts_sim_run(&sim, c->sched, lcm, max_phase);
+
+		r->horizon = sim.clock;
+		r->jobs = sim.total_jobs;
+		r->iters++;
+		r->sec = bench_now() - t0;
+	} while (r->sec < bench_min_sec);
+
+	free(tasks);
+	free(orig);
+	return 0;
+}
+
+static int bench_rq(const struct bench_case *c, struct bench_result *r) {
+	const struct bench_shape *shape = &bench_shapes[0];
+	struct rts_task *tasks = bench_tasks(shape, c->n);
+	struct rts_job *jobs = calloc((size_t)c->n, sizeof(*jobs));
+	struct rts_rq rq;
+	rts_time_t clock = 0;
+
+	/* Per-task ranks for the orders that need them, as rts_sim_start() does */
+	if (!tasks || !jobs ||
+	    (c->sched->prepare && c->sched->prepare(tasks, c->n) != 0) ||
+	    rts_rq_setup(&rq, c->rq_ops, c->sched, tasks, &clock) != 0) {
+		free(jobs);
+		free(tasks);
+		return -1;
+	}
+
+	/* One pending job per task, released over the last period */
+	srand(BENCH_SEED);
+	for (int i = 0; i < c->n; i++) {
+		struct rts_job *j = &jobs[i];
+
+		j->tid = i;
+		j->jid = 1;
+		j->release_time = rand() % tasks[i].period;
+		j->abs_deadline = j->release_time + tasks[i].rel_deadline;
+		j->remain = 1 + rand() % tasks[i].wcet;
+		j->start = -1;
+		j->cpu = -1;
+	}
+
+	double t0 = bench_now();
+	do {
+		for (int i = 0; i < c->n; i++)
+			rts_rq_insert(&rq, &jobs[i]);
+
+		struct rts_job *j;
+		while ((j = rts_rq_peek(&rq)))
+			rts_rq_erase(&rq, j);
+
+		r->iters++;
+		r->sec = bench_now() - t0;
+	} while (r->sec < bench_min_sec);
+
+	r->ops = 2L * c->n;
+	rts_rq_destroy(&rq);
+	free(jobs);
+	free(tasks);
+	return 0;
+}
+
+static int bench_pool(const struct bench_case *c, struct bench_result *r) {
+	struct rts_job **live = malloc(sizeof(*live) * (size_t)c->n);
+	struct rts_job_pool pool;
+
+	if (!live)
+		return -1;
+	rts_job_pool_init(&pool);
+
+	/* The first round grows the pool; later ones only recycle */
+	double t0 = bench_now();
+	do {
+		for (int i = 0; i < c->n; i++) {
+			live[i] = rts_job_pool_alloc(&pool);
+			if (!live[i]) {
+				rts_job_pool_destroy(&pool);
+				free(live);
+				return -1;
+			}
+		}
+		for (int i = 0; i < c->n; i++)
+			rts_job_pool_free(&pool, live[i]);
+
+		r->iters++;
+		r->sec = bench_now() - t0;
+	} while (r->sec < bench_min_sec);
+
+	r->ops = 2L * c->n;
+	rts_job_pool_destroy(&pool);
+	free(live);
+	return 0;
+}
+
+static int bench_parse(const struct bench_case *c, struct bench_result *r) {
+	char path[] = "/tmp/rts-bench-XXXXXX";
+	struct rts_task *tasks = bench_tasks(c->shape, c->n);
+	int fd = mkstemp(path);
+	FILE *fp = fd >= 0 ? fdopen(fd, "w") : NULL;
+	int ret = -1;
+
+	if (!tasks || !fp) {
+		if (fd >= 0 && !fp)
+			close(fd);
+		goto out;
+	}
+
+	int werr = strcmp(c->bench, "parse-bin") == 0 ?
+	           rts_parser_write_binary(fp, tasks, c->n) :
+	           rts_gen_write(fp, tasks, c->n);
+	if (fclose(fp) != 0 || werr != 0)
+		goto out;
+
+	double t0 = bench_now();
+	do {
+		int n_tasks;
+		struct rts_task *parsed = rts_parser_load_tasks(path, &n_tasks);
+
+		if (!parsed)
+			goto out;
+		free(parsed);
+
+		r->iters++;
+		r->sec = bench_now() - t0;
+	} while (r->sec < bench_min_sec);
+
+	r->ops = c->n;
+	ret = 0;
+out:
+	if (fd >= 0)
+		unlink(path);
+	free(tasks);
+	return ret;
+}
+
+static long bench_peak_rss_kb(void) {
+	struct rusage ru;
+
+	if (getrusage(RUSAGE_SELF, &ru) != 0)
+		return -1;
+	return ru.ru_maxrss;
+}
+
+static void bench_print_header(void) {
+	printf("bench,sched,rq,engine,shape,n,hyperperiod,iters,sec,"
+	       "ticks_per_sec,jobs_per_sec,ops_per_sec,peak_rss_kb\n");
+}
+
+static void bench_print_row(const struct bench_case *c, const struct bench_result *r) {
+	double per = r->sec / r->iters;
+
+	printf("%s,%s,%s,%s,%s,%d,", c->bench,
+	       c->sched ? c->sched->name : "-",
+	       c->rq_ops ? c->rq_ops->name : "-",
+	       c->engine < 0 ? "-" : (c->engine == RTS_ENGINE_EVENT ? "event" : "tick"),
+	       c->shape ? c->shape->name : "-", c->n);
+
+	if (r->horizon)
+		printf("%" PRId64 ",", r->horizon);
+	else
+		printf("-,");
+	printf("%ld,%.6f,", r->iters, r->sec);
+
+	if (r->horizon)
+		printf("%.0f,%.0f,-,", r->horizon / per, r->jobs / per);
+	else
+		printf("-,-,%.0f,", r->ops / per);
+	printf("%ld\n", bench_peak_rss_kb());
+}
+
+/**
+ * bench_run - run one case in a child process and print its row
+ *
+ * Falls back to the calling process if fork() fails; the RSS column is
+ * then a high-water mark over every case run so far.
+ */
+static void bench_run(const struct bench_case *c) {
+	fprintf(stderr, "[bench] %s %s %s %s %s n=%d\n", c->bench,
+	        c->sched ? c->sched->name : "",
+	        c->rq_ops ? c->rq_ops->name : "",
+	        c->engine < 0 ? "" : (c->engine == RTS_ENGINE_EVENT ? "event" : "tick"),
+	        c->shape ? c->shape->name : "", c->n);
+	fflush(stdout);
+
+	pid_t pid = fork();
+	if (pid > 0) {
+		int status;
+
+		if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status))
+			fprintf(stderr, "[bench] case failed\n");
+		return;
+	}
+
+	struct bench_result r = { 0 };
+	int ret;
+
+	if (strcmp(c->bench, "sim") == 0)
+		ret = bench_sim(c, &r);
+	else if (strcmp(c->bench, "rq") == 0)
+		ret = bench_rq(c, &r);
+	else if (strcmp(c->bench, "pool") == 0)
+		ret = bench_pool(c, &r);
+	else
+		ret = bench_parse(c, &r);
+
+	if (ret == 0)
+		bench_print_row(c, &r);
+	fflush(stdout);
+
+	if (pid == 0)
+		_exit(ret == 0 ? 0 : 1);
+	if (ret != 0)
+		fprintf(stderr, "[bench] case failed\n");
+}
+
+/**
+ * bench_backends - ready queue backends worth timing under @sched
+ *
+ * The generic list and heap, plus the policy's specialized backend.
+ */
+static int bench_backends(const struct rts_sched_class *sched,
+                          const struct rts_rq_ops **out) {
+	int n = 0;
+
+	out[n++] = &rts_rq_list_ops;
+	out[n++] = &rts_rq_heap_ops;
+	if (sched->rq_ops && sched->rq_ops != &rts_rq_list_ops &&
+	    sched->rq_ops != &rts_rq_heap_ops)
+		out[n++] = sched->rq_ops;
+	return n;
+}
+
+static int bench_selected(const char *only, const char *bench) {
+	size_t len = strlen(bench);
+
+	if (!only)
+		return 1;
+	for (const char *p = only; *p;) {
+		size_t n = strcspn(p, ",");
+
+		if (n == len && strncmp(p, bench, len) == 0)
+			return 1;
+		p += n + (p[n] == ',');
+	}
+	return 0;
+}
+
+static void usage(const char *prog) {
+	fprintf(stderr, "Usage: %s [--quick] [--generic] [--min-time=SEC]\n"
+	                "       %*s [--only=sim,rq,pool,parse,parse-bin]\n",
+	        prog, (int)strlen(prog), "");
+}
+
+/**
+ * struct bench_fp_sched - a built-in scheduler forced onto higher_prio()
+ * @class: copy of the scheduler with RTS_PRIO_CUSTOM
+ * @name:  its name, e.g. "EDF-fp"
+ */
+struct bench_fp_sched {
+	struct rts_sched_class class;
+	char name[32];
+};
+
+/**
+ * bench_scheds - registered schedulers, then with @generic a copy of
+ * each built-in one that orders jobs only through higher_prio()
+ *
+ * Returns a NULL-terminated array that lives until exit; exits if it
+ * cannot be allocated.
+ */
+static const struct rts_sched_class **bench_scheds(int generic) {
+	const struct rts_sched_class *const *all = rts_sched_list();
+	int n = 0, k = 0;
+
+	while (all[n])
+		n++;
+
+	const struct rts_sched_class **out = malloc(sizeof(*out) * (size_t)(2 * n + 1));
+	struct bench_fp_sched *fp = calloc((size_t)(n > 0 ? n : 1), sizeof(*fp));
+	if (!out || !fp) {
+		fprintf(stderr, "[bench] out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (int i = 0; i < n; i++)
+		out[k++] = all[i];
+
+	for (int i = 0; generic && i < n; i++) {
+		if (all[i]->prio == RTS_PRIO_CUSTOM)
+			continue;
+
+		fp[i].class = *all[i];
+		fp[i].class.prio = RTS_PRIO_CUSTOM;
+		snprintf(fp[i].name, sizeof(fp[i].name), "%s-fp", all[i]->name);
+		fp[i].class.name = fp[i].name;
+		out[k++] = &fp[i].class;
+	}
+	out[k] = NULL;
+
+	return out;
+}
+
+int main(int argc, char **argv) {
+	const char *only = NULL;
+	int generic = 0;
+	const int *sizes = bench_sizes;
+	int n_sizes = (int)(sizeof(bench_sizes) / sizeof(bench_sizes[0]));
+	int n_shapes = (int)(sizeof(bench_shapes) / sizeof(bench_shapes[0]));
+
+	for (int i = 1; i < argc; i++) {
+		const char *opt = argv[i];
+
+		if (strcmp(opt, "--quick") == 0) {
+			sizes = bench_sizes_quick;
+			n_sizes = (int)(sizeof(bench_sizes_quick) / sizeof(bench_sizes_quick[0]));
+			n_shapes = 1;
+		} else if (strcmp(opt, "--generic") == 0) {
+			generic = 1;
+		} else if (strncmp(opt, "--min-time=", 11) == 0) {
+			bench_min_sec = atof(opt + 11);
+		} else if (strncmp(opt, "--only=", 7) == 0) {
+			only = opt + 7;
+		} else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	const struct rts_sched_class **scheds = bench_scheds(generic);
+
+	bench_print_header();
+
+	for (int s = 0; scheds[s] && bench_selected(only, "sim"); s++) {
+		const struct rts_rq_ops *backends[3];
+		int n_backends = bench_backends(scheds[s], backends);
+
+		for (int b = 0; b < n_backends; b++)
+			for (int e = RTS_ENGINE_TICK; e <= RTS_ENGINE_EVENT; e++)
+				for (int w = 0; w < n_shapes; w++)
+					for (int k = 0; k < n_sizes; k++)
+						bench_run(&(struct bench_case){
+						    "sim", scheds[s], backends[b], e, &bench_shapes[w], sizes[k] });
+	}
+
+	for (int s = 0; scheds[s] && bench_selected(only, "rq"); s++) {
+		const struct rts_rq_ops *backends[3];
+		int n_backends = bench_backends(scheds[s], backends);
+
+		for (int b = 0; b < n_backends; b++)
+			for (int k = 0; k < n_sizes; k++)
+				bench_run(&(struct bench_case){
+				    "rq", scheds[s], backends[b], -1, NULL, sizes[k] * 10 });
+	}
+
+	for (int k = 0; k < n_sizes && bench_selected(only, "pool"); k++)
+		bench_run(&(struct bench_case){ "pool", NULL, NULL, -1, NULL, sizes[k] * 10 });
+
+	for (int k = 0; k < n_sizes && bench_selected(only, "parse"); k++)
+		bench_run(&(struct bench_case){ "parse", NULL, NULL, -1, &bench_shapes[0], sizes[k] * 10 });
+
+	for (int k = 0; k < n_sizes && bench_selected(only, "parse-bin"); k++)
+		bench_run(&(struct bench_case){ "parse-bin", NULL, NULL, -1, &bench_shapes[0], sizes[k] * 10 });
+
+	return 0;
+}
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_analysis.h
+ * @brief Analytic schedulability tests.
+ *
+ * These answer "can any job miss its deadline?" without simulating, and
+ * assume the worst-case (synchronous) release of every task.  For task
+ * sets with release offsets they are sufficient rather than exact.
+ */
+#ifndef RTS_ANALYSIS_H
+#define RTS_ANALYSIS_H
+
+#include "rts_types.h"
+
+/**
+ * rts_analysis_rta - exact response-time analysis for fixed priorities
+ * @tasks: task set
+ * @n:     number of tasks
+ * @order: task indices, highest priority first
+ * @resp:  output worst-case response time per task index; a value above
+ *         the task's deadline means the task can miss (the iteration
+ *         stops there, so it is a lower bound on the true response time)
+ *
+ * Deadlines may exceed periods: each task's level-i busy period is
+ * examined job by job.  Iterations for a task start from the response
+ * time of the next higher-priority task, which lower-bounds its own.
+ *
+ * Returns the number of tasks that can miss their deadline.
+ */
+int rts_analysis_rta(const struct rts_task *tasks, int n, const int *order,
+                     rts_time_t *resp);
+
+/**
+ * rts_analysis_rta_pt - response-time analysis with preemption thresholds
+ * @tasks:  task set
+ * @n:      number of tasks
+ * @order:  task indices, highest priority first
+ * @thresh: per task index, a position in @order: once one of its jobs has
+ *          started, only tasks ranked above that position preempt it (its
+ *          own position: fully preemptive; 0: non-preemptive)
+ * @resp:   output as for rts_analysis_rta()
+ *
+ * Wang & Saksena's analysis: a task is blocked by the longest job ranked
+ * below it whose threshold it does not clear, and each of its jobs is
+ * split at its start time, before which every higher-ranked task
+ * interferes and after which only those above its threshold do.  Every
+ * job in the level-i busy period, blocking included, is examined, and a
+ * task whose level uses the whole processor counts as missing.  The
+ * blocking makes it sufficient rather than exact even without offsets.
+ *
+ * Returns the number of tasks that can miss their deadline.
+ */
+int rts_analysis_rta_pt(const struct rts_task *tasks, int n, const int *order,
+                        const int *thresh, rts_time_t *resp);
+
+/**
+ * rts_analysis_pt_assign - raise every preemption threshold as far as
+ * rts_analysis_rta_pt() allows
+ * @tasks:  task set
+ * @n:      number of tasks
+ * @order:  task indices, highest priority first
+ * @thresh: output per task index, as for rts_analysis_rta_pt()
+ *
+ * Each task's tolerance, the longest blocking it takes while still
+ * meeting its deadline when fully preemptive, is bisected once; a task's
+ * threshold then rises past every higher-ranked task whose tolerance
+ * covers the task's WCET - 1.  Blocking thus stays within every
+ * tolerance, so each task that meets its deadline fully preemptive still
+ * does, and raising its own threshold only takes interference away.
+ *
+ * Returns 0 on success, -1 if memory runs out.
+ */
+int rts_analysis_pt_assign(const struct rts_task *tasks, int n, const int *order,
+                           int *thresh);
+
+/**
+ * rts_analysis_rm_order - task indices in RM priority order
+ * @tasks: task set
+ * @n:     number of tasks
+ * @order: output @n task indices, highest priority first
+ *
+ * Matches rts_prio_rm(): shorter period first, then lower TID.
+ *
+ * Returns 0 on success, -1 if memory runs out.
+ */
+int rts_analysis_rm_order(const struct rts_task *tasks, int n, int *order);
+
+/**
+ * struct rts_analysis_dbf - outcome of a processor-demand test
+ * @util_over: nonzero if utilization exceeds 1 (no interval is searched)
+ * @bound:     length L of the interval [0, L] that had to be checked
+ * @points:    number of demand evaluations performed
+ * @fail_at:   smallest t with h(t) > t, or -1 if there is none
+ * @demand:    h(@fail_at), the work due within [0, @fail_at]
+ */
+struct rts_analysis_dbf {
+	int util_over;
+	rts_time_t bound;
+	long points;
+	rts_time_t fail_at;
+	rts_time_t demand;
+};
+
+/**
+ * rts_analysis_qpa - exact EDF test by Quick Processor-demand Analysis
+ * @tasks: task set
+ * @n:     number of tasks
+ * @res:   output details
+ *
+ * The demand bound h(t) is the work of every job with its release and
+ * deadline inside [0, t]; EDF meets all deadlines iff h(t) <= t for all
+ * t.  Only t up to the shorter of the synchronous busy period and the
+ * Zhang & Burns bound matter, and instead of visiting every absolute
+ * deadline below it the search walks backwards: h(t) < t rules out the
+ * whole range [h(t), t], so the next point examined is h(t) itself.
+ * Deadlines may exceed periods.
+ *
+ * Returns 1 if the task set is schedulable, 0 if not, -1 if the bound
+ * does not fit the time range.
+ */
+int rts_analysis_qpa(const struct rts_task *tasks, int n,
+                     struct rts_analysis_dbf *res);
+
+#endif /* RTS_ANALYSIS_H */
@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_api.h
+ * @brief Embeddable simulator interface (librts).
+ *
+ * An rts_instance is one uniprocessor simulation that the caller advances
+ * in steps and inspects in between.  Instances share no state, so any
+ * number may exist at once and on different threads (one thread per
+ * instance at a time).  Nothing is written to stdout; errors go to
+ * stderr.
+ *
+ *	struct rts_config cfg = { .sched = "EDF", .tasks = tasks, .n_tasks = n };
+ *	struct rts_instance *rt = rts_create(&cfg);
+ *
+ *	rts_step_until(rt, 1000);
+ *	rts_get_results(rt, &res);
+ *	rts_reset(rt);
+ *	...
+ *	rts_destroy(rt);
+ *
+ * A started instance can be saved to a file and loaded back, or forked in
+ * memory, to explore what-if variations from a common prefix:
+ *
+ *	rts_step_until(rt, warmup);
+ *	struct rts_instance *alt = rts_fork(rt, NULL);
+ *	rts_set_task(alt, 2, 50, 50, 12);
+ *	rts_run(rt);
+ *	rts_run(alt);
+ *
+ * Build with "make lib" for build/librts.a and build/librts.so.
+ */
+#ifndef RTS_API_H
+#define RTS_API_H
+
+#include "rts_sim.h"
+#include "rts_types.h"
+
+#include <stdio.h>
+
+struct rts_instance;
+
+/**
+ * struct rts_config - what an instance simulates
+ * @sched:   policy name ("RM", "EDF", "LST", "NP-RM", "NP-EDF", "RM-PT")
+ * @rq:      ready queue backend name (NULL: the policy's own)
+ * @engine:  enum rts_engine; both give the same results
+ * @tasks:   task set, copied; only phase, period, rel_deadline and wcet
+ *           are read, tids are assigned in order
+ * @n_tasks: number of tasks
+ * @hooks:   event callbacks (NULL: none); must outlive the instance
+ * @switch_cost: time charged to a job each time it preempts another
+ *           (0: free)
+ */
+struct rts_config {
+	const char *sched;
+	const char *rq;
+	int engine;
+	const struct rts_task *tasks;
+	int n_tasks;
+	const struct rts_hooks *hooks;
+	int switch_cost;
+};
+
+/**
+ * struct rts_results - counters since the start or the last reset
+ * @clock:       simulated time reached
+ * @total_jobs:  jobs released
+ * @missed_jobs: jobs that missed, or could no longer meet, their deadline
+ * @preemptions: jobs switched out before completing
+ * @switches:    dispatches of a job other than the one that ran before
+ * @overhead:    time charged for preemptions
+ */
+struct rts_results {
+	rts_time_t clock;
+	int64_t total_jobs;
+	int64_t missed_jobs;
+	long preemptions;
+	long switches;
+	rts_time_t overhead;
+};
+
+/**
+ * rts_create - set up a simulation at time 0
+ * @cfg: configuration
+ *
+ * Returns NULL if a name is unknown, a task has a non-positive period or
+ * wcet, the switch cost is negative, or memory runs out.
+ */
+struct rts_instance *rts_create(const struct rts_config *cfg);
+
+/**
+ * rts_destroy - free an instance (NULL is ignored)
+ */
+void rts_destroy(struct rts_instance *rt);
+
+/**
+ * rts_reset - restart from time 0 with the same configuration
+ *
+ * Returns 0 on success, -1 if memory runs out (the instance can then
+ * only be destroyed).
+ */
+int rts_reset(struct rts_instance *rt);
+
+/**
+ * rts_step_until - simulate up to time @t
+ *
+ * Everything before @t happens: releases, execution, completions, and
+ * deadline checks up to and including @t.  Does nothing if the clock is
+ * already at or past @t.
+ */
+void rts_step_until(struct rts_instance *rt, rts_time_t t);
+
+/**
+ * rts_run - simulate to the end of the hyperperiod (lcm + max phase),
+ * the span the command-line simulator covers
+ *
+ * Returns 0 on success, -1 if the hyperperiod does not fit rts_time_t.
+ */
+int rts_run(struct rts_instance *rt);
+
+/**
+ * rts_now - current simulated time
+ */
+rts_time_t rts_now(const struct rts_instance *rt);
+
+/**
+ * rts_get_results - copy the counters
+ */
+void rts_get_results(const struct rts_instance *rt, struct rts_results *out);
+
+/**
+ * rts_get_tasks - the instance's task set with per-task counters
+ * (release_count, preemptions)
+ * @n_tasks: output number of tasks
+ *
+ * The array belongs to the instance.
+ */
+const struct rts_task *rts_get_tasks(const struct rts_instance *rt, int *n_tasks);
+
+/**
+ * rts_save - write the instance's state as a snapshot (see rts_snapshot.h)
+ * @fp: destination, opened in binary mode
+ *
+ * Hooks are not saved.  Returns 0 on success, -1 on a write error or
+ * running out of memory.
+ */
+int rts_save(const struct rts_instance *rt, FILE *fp);
+
+/**
+ * rts_load - create an instance from a snapshot written by rts_save()
+ * @fp:    source, opened in binary mode
+ * @hooks: event callbacks for the new instance (NULL: none)
+ *
+ * Stepping it on gives what the saved instance would have given.  Its
+ * results count from the saved instance's start, and rts_reset() goes
+ * back to time 0.  Returns NULL if the snapshot is malformed, names an
+ * unknown policy or backend, or memory runs out.
+ */
+struct rts_instance *rts_load(FILE *fp, const struct rts_hooks *hooks);
+
+/**
+ * rts_fork - copy an instance in its current state
+ * @hooks: event callbacks for the copy (NULL: none)
+ *
+ * Costs O(tasks + queued jobs).  The two instances then evolve
+ * independently.  Returns NULL if memory runs out.
+ */
+struct rts_instance *rts_fork(const struct rts_instance *rt,
+                              const struct rts_hooks *hooks);
+
+/**
+ * rts_set_task - change a task's parameters from now on
+ * @tid:          task index
+ * @period:       new period, taking effect after its next release
+ * @rel_deadline: new relative deadline of jobs released from now on
+ * @wcet:         new execution time of jobs released from now on
+ *
+ * Jobs already released keep their deadline and remaining time; a new
+ * period reorders the ready queue, for policies ranking jobs by it, and
+ * policies deriving per-task state (RM-PT's thresholds) derive it anew.
+ * Returns 0 on success, -1 if @tid is out of range, @period or @wcet is
+ * not positive, or memory runs out.
+ */
+int rts_set_task(struct rts_instance *rt, int tid, int period,
+                 int rel_deadline, int wcet);
+
+#endif /* RTS_API_H */
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_batch.h
+ * @brief Parallel batch runner for many task files x schedulers.
+ *
+ * Every task file is parsed once; each (file, policy) pair is an
+ * independent simulation run by a pthread worker pool with per-worker
+ * work-stealing deques.  Results are gathered into one summary table.
+ */
+#ifndef RTS_BATCH_H
+#define RTS_BATCH_H
+
+#include <stdio.h>
+
+struct rts_sched_class;
+struct rts_rq_ops;
+
+/**
+ * struct rts_batch_opts - batch configuration
+ * @paths:     task files to simulate
+ * @n_paths:   number of task files
+ * @scheds:    policies to run on every file
+ * @n_scheds:  number of policies
+ * @rq_ops:    ready queue backend (NULL: each policy's default)
+ * @engine:    enum rts_engine
+ * @n_workers: worker threads (<= 0: one per online CPU)
+ * @outdir:    trace directory (NULL: no traces)
+ * @trace_fmt: enum rts_trace_format
+ * @steady:    stop each run once its schedule repeats
+ * @report:    stream receiving one JSON report per run (NULL: none)
+ * @task_stats: add per-task timing histograms to each report
+ * @switch_cost: time charged per preemption (0: free)
+ */
+struct rts_batch_opts {
+	char **paths;
+	int n_paths;
+	const struct rts_sched_class **scheds;
+	int n_scheds;
+	const struct rts_rq_ops *rq_ops;
+	int engine;
+	int n_workers;
+	const char *outdir;
+	int trace_fmt;
+	int steady;
+	FILE *report;
+	int task_stats;
+	int switch_cost;
+};
+
+/**
+ * rts_batch_add_paths - expand a glob pattern or literal path
+ * @paths:   growable path array (may be NULL initially)
+ * @n_paths: number of entries, updated
+ * @arg:     path or glob pattern (e.g., "input/test?.txt")
+ *
+ * Returns 0 on success, -1 on failure.
+ */
+int rts_batch_add_paths(char ***paths, int *n_paths, const char *arg);
+
+/**
+ * rts_batch_add_manifest - add every path listed in a manifest file
+ * @paths:    growable path array
+ * @n_paths:  number of entries, updated
+ * @manifest: file with one path or glob per line ('#' starts a comment)
+ *
+ * Returns 0 on success, -1 on failure.
+ */
+int rts_batch_add_manifest(char ***paths, int *n_paths, const char *manifest);
+
+/**
+ * rts_batch_free_paths - release an array built by rts_batch_add_*()
+ */
+void rts_batch_free_paths(char **paths, int n_paths);
+
+/**
+ * rts_batch_run - run every (file, policy) simulation and print a summary
+ * @opts: batch configuration
+ * @out:  summary table destination
+ *
+ * Task files whose stems match would share a trace directory, so with
+ * traces on such a batch is refused before anything runs.
+ *
+ * Returns 0 if every simulation ran, 1 if any task file failed to load or
+ * the batch was refused.
+ */
+int rts_batch_run(const struct rts_batch_opts *opts, FILE *out);
+
+#endif /* RTS_BATCH_H */
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_calendar.h
+ * @brief Release calendar.
+ *
+ * Min-heap of tasks keyed on rts_task::next_release (ties by tid), so the
+ * simulator only touches the tasks that actually release at a given time.
+ */
+#ifndef RTS_CALENDAR_H
+#define RTS_CALENDAR_H
+
+#include "rts_types.h"
+
+/**
+ * rts_calendar_init - compute every task's first release and build the heap
+ * @cal:   release calendar
+ * @tasks: task set
+ * @n:     number of tasks
+ * @now:   simulation start time; earlier releases are skipped
+ *
+ * Returns 0 on success, -1 on allocation failure.
+ */
+int rts_calendar_init(struct rts_calendar *cal, struct rts_task *tasks,
+                      int n, rts_time_t now);
+
+/**
+ * rts_calendar_build - build the heap from every task's current
+ * next_release, e.g. when resuming a saved simulation
+ *
+ * Returns 0 on success, -1 on allocation failure.
+ */
+int rts_calendar_build(struct rts_calendar *cal, struct rts_task *tasks, int n);
+
+/**
+ * rts_calendar_destroy - release calendar storage
+ */
+void rts_calendar_destroy(struct rts_calendar *cal);
+
+/**
+ * rts_calendar_next - earliest pending release time, or RTS_TIME_MAX if none
+ */
+rts_time_t rts_calendar_next(const struct rts_calendar *cal,
+                             const struct rts_task *tasks);
+
+/**
+ * rts_calendar_due - task releasing at @now with the lowest tid
+ *
+ * Returns the task index, or -1 if no task releases at @now.  Call
+ * rts_calendar_advance() after releasing the job.
+ */
+int rts_calendar_due(const struct rts_calendar *cal,
+                     const struct rts_task *tasks, rts_time_t now);
+
+/**
+ * rts_calendar_advance - move the earliest task to its next period
+ */
+void rts_calendar_advance(struct rts_calendar *cal, struct rts_task *tasks);
+
+#endif /* RTS_CALENDAR_H */
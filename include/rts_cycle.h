@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_cycle.h
+ * @brief Steady-state detection at hyperperiod boundaries.
+ *
+ * At every multiple of the hyperperiod the release pattern ahead is the
+ * same, so the future schedule depends only on the scheduler state: each
+ * task's offset to its next release and every ready job's remaining work,
+ * deadline offset, whether it has started and, when preemptions cost
+ * time, whether it ran last.  Once that state repeats, the schedule between the
+ * two boundaries repeats forever and the simulation can stop.
+ */
+#ifndef RTS_CYCLE_H
+#define RTS_CYCLE_H
+
+#include "rts_types.h"
+
+#include <stdint.h>
+
+struct rts_cycle_snap;
+
+/**
+ * struct rts_cycle - states recorded at hyperperiod boundaries
+ * @period: hyperperiod; states are sampled at its multiples
+ * @snaps:  recorded states, oldest first
+ * @nr:     number of recorded states
+ * @cap:    capacity of @snaps
+ */
+struct rts_cycle {
+	rts_time_t period;
+	struct rts_cycle_snap *snaps;
+	int nr;
+	int cap;
+};
+
+/**
+ * rts_cycle_init - start with no recorded states
+ * @cyc:    detector
+ * @period: hyperperiod
+ */
+void rts_cycle_init(struct rts_cycle *cyc, rts_time_t period);
+
+/**
+ * rts_cycle_destroy - release every recorded state
+ */
+void rts_cycle_destroy(struct rts_cycle *cyc);
+
+/**
+ * rts_cycle_boundary - whether @now is a hyperperiod boundary to sample
+ */
+static inline int rts_cycle_boundary(const struct rts_cycle *cyc, rts_time_t now) {
+	return now % cyc->period == 0;
+}
+
+/**
+ * rts_cycle_next_boundary - first boundary strictly after @now
+ */
+static inline rts_time_t rts_cycle_next_boundary(const struct rts_cycle *cyc,
+                                                 rts_time_t now) {
+	return (now / cyc->period + 1) * cyc->period;
+}
+
+/**
+ * rts_cycle_check - record the state of @sim and look for an earlier match
+ * @cyc: detector
+ * @sim: simulation at a boundary, after the deadline check
+ *
+ * Returns the time of the earlier boundary with the same state, or -1 if
+ * the state is new (or could not be recorded).
+ */
+rts_time_t rts_cycle_check(struct rts_cycle *cyc, const struct rts_sim *sim);
+
+#endif /* RTS_CYCLE_H */
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_gen.h
+ * @brief Synthetic task set generator.
+ *
+ * Utilizations are split with UUniFast (Bini & Buttazzo), or with
+ * UUniFast-discard when the total exceeds 1 and per-task utilizations
+ * must still stay at most 1.  Periods are drawn log-uniformly, or from a
+ * harmonic or divisor set so that the hyperperiod stays bounded:
+ *   - loguniform: any period in [tmin, tmax]
+ *   - harmonic:   tmin * 2^k <= tmax; the hyperperiod is the largest one
+ *   - divisor:    divisors of tmax; the hyperperiod divides tmax
+ * WCETs are whole time units (at least 1), and each one also makes up the
+ * rounding error of those before it.  tmin is raised so that an average
+ * utilization share spans two units of its period; a set whose rounded
+ * utilization is still more than 5% off the request is rejected.
+ *
+ * The same seed always yields the same task set.
+ */
+#ifndef RTS_GEN_H
+#define RTS_GEN_H
+
+#include "rts_types.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+enum rts_gen_periods {
+	RTS_GEN_LOGUNIFORM = 0,
+	RTS_GEN_HARMONIC,
+	RTS_GEN_DIVISOR,
+};
+
+/**
+ * struct rts_gen_opts - task set parameters
+ * @n_tasks:     number of tasks
+ * @util:        total utilization
+ * @discard:     use UUniFast-discard (required when @util > 1)
+ * @periods:     enum rts_gen_periods
+ * @tmin:        smallest period
+ * @tmax:        largest period (the divisor base with RTS_GEN_DIVISOR)
+ * @constrained: draw deadlines uniformly in [wcet, period] instead of
+ *               using the period
+ * @phased:      draw release offsets uniformly in [0, period)
+ * @seed:        PRNG seed
+ */
+struct rts_gen_opts {
+	int n_tasks;
+	double util;
+	int discard;
+	int periods;
+	int tmin;
+	int tmax;
+	int constrained;
+	int phased;
+	uint64_t seed;
+};
+
+/**
+ * rts_gen_defaults - 10 implicit-deadline tasks at U=0.7, periods
+ * log-uniform in [30, 1000], seed 1
+ */
+void rts_gen_defaults(struct rts_gen_opts *opts);
+
+/**
+ * rts_gen_parse - update @opts from a "key=value,..." specification
+ * @opts: options, usually from rts_gen_defaults()
+ * @spec: e.g. "n=1000,u=0.9,periods=harmonic,tmin=2560,tmax=40960,seed=7";
+ *        keys: n, u, split (uunifast|discard), periods (loguniform|
+ *        harmonic|divisor), tmin, tmax, deadlines (implicit|constrained),
+ *        phased (0|1), seed
+ *
+ * Returns 0 on success, -1 on an unknown key or bad value.
+ */
+int rts_gen_parse(struct rts_gen_opts *opts, const char *spec);
+
+/**
+ * rts_gen_tasks - generate a task set
+ * @opts:        parameters
+ * @n_tasks_out: output number of tasks
+ *
+ * Tasks are initialized as rts_parser_load_tasks() would, so the array
+ * can be simulated directly.
+ *
+ * Returns a malloc'd array, or NULL if the parameters are invalid, leave
+ * no room for the raised tmin, or the rounded utilization is too far from
+ * @opts->util.
+ */
+struct rts_task *rts_gen_tasks(const struct rts_gen_opts *opts, int *n_tasks_out);
+
+/**
+ * rts_gen_write - write a task set in the format rts_parser_load_tasks()
+ * reads
+ *
+ * Returns 0 on success, -1 on a write error.
+ */
+int rts_gen_write(FILE *fp, const struct rts_task *tasks, int n_tasks);
+
+#endif /* RTS_GEN_H */
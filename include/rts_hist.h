@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_hist.h
+ * @brief Fixed-size log-bucketed histograms and per-task timing statistics.
+ *
+ * Buckets follow the HDR histogram layout: values below 2^RTS_HIST_SUB_BITS
+ * get a bucket each, and every further power of two is split into
+ * 2^RTS_HIST_SUB_BITS equal sub-buckets, so a bucket is never wider than
+ * 1/2^RTS_HIST_SUB_BITS of its values.  Negative values use a separate set
+ * of buckets by magnitude.  Each side keeps only the buckets up to the
+ * largest magnitude it expects, at most 2^32 - 1; larger ones share its
+ * last bucket.  Min, max, count and mean are exact; percentiles are exact
+ * up to the bucket width.
+ *
+ * The size does not depend on how many values are recorded, so statistics
+ * gathered over any horizon take constant memory.
+ */
+#ifndef RTS_HIST_H
+#define RTS_HIST_H
+
+#include "rts_types.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Sub-buckets per power of two: 2^4, i.e. at most 6.25% wide */
+#define RTS_HIST_SUB_BITS 4
+#define RTS_HIST_SUB      (1 << RTS_HIST_SUB_BITS)
+
+/* Resolved magnitudes: [0, 2^RTS_HIST_RANGE_BITS) */
+#define RTS_HIST_RANGE_BITS 32
+
+/* Most buckets on one side: all resolved ones plus one for larger magnitudes */
+#define RTS_HIST_BUCKETS \
+	(RTS_HIST_SUB + (RTS_HIST_RANGE_BITS - RTS_HIST_SUB_BITS) * RTS_HIST_SUB + 1)
+
+/**
+ * struct rts_hist - log-bucketed histogram; all zeroes is an empty one
+ *                   without buckets (exact min, max, count and mean only)
+ * @count: values recorded
+ * @min:   smallest value (valid if @count)
+ * @max:   largest value (valid if @count)
+ * @sum:   sum of values, for the mean
+ * @n_pos: buckets in @pos; the last one also takes larger values
+ * @n_neg: buckets in @neg; the last one also takes larger magnitudes
+ * @pos:   counts of values >= 0 by bucket
+ * @neg:   counts of values < 0 by bucket of their magnitude
+ */
+struct rts_hist {
+	uint64_t count;
+	int64_t min;
+	int64_t max;
+	double sum;
+	int n_pos;
+	int n_neg;
+	uint64_t *pos;
+	uint64_t *neg;
+};
+
+/**
+ * struct rts_task_stats - timing of one task's completed jobs
+ * @response: completion - release
+ * @lateness: completion - absolute deadline (negative: early)
+ * @start:    first dispatch - release; its spread is the start jitter
+ *
+ * Jobs that cannot finish by their deadline are dropped, so completed
+ * ones have response and start delay in [0, D] and lateness in [-D, 0]
+ * for relative deadline D; the buckets cover just those ranges.
+ */
+struct rts_task_stats {
+	struct rts_hist response;
+	struct rts_hist lateness;
+	struct rts_hist start;
+};
+
+/**
+ * rts_hist_record - add one value
+ */
+void rts_hist_record(struct rts_hist *h, int64_t v);
+
+/**
+ * rts_hist_percentile - value below or at which @p percent of values lie
+ * @h: histogram
+ * @p: percentile in [0, 100]
+ *
+ * Returns the upper bound of the bucket reached, clamped to [min, max],
+ * or 0 for an empty histogram.
+ */
+int64_t rts_hist_percentile(const struct rts_hist *h, double p);
+
+/**
+ * rts_hist_mean - mean of the recorded values (0 if none)
+ */
+double rts_hist_mean(const struct rts_hist *h);
+
+/**
+ * rts_task_stats_alloc - zeroed statistics for @n_tasks tasks, with
+ * buckets sized to each task's relative deadline
+ *
+ * Returns one block to be released with free(), or NULL on allocation
+ * failure.
+ */
+struct rts_task_stats *rts_task_stats_alloc(const struct rts_task *tasks, int n_tasks);
+
+/**
+ * rts_task_stats_record - account a job that completed at @done
+ */
+void rts_task_stats_record(struct rts_task_stats *ts, const struct rts_job *job,
+                           rts_time_t done);
+
+/**
+ * rts_task_stats_print - one line per task: min/mean/p99/max of response
+ * time, lateness and start delay, and the start and response jitter
+ * (max - min)
+ */
+void rts_task_stats_print(const struct rts_task_stats *ts, int n_tasks, FILE *out);
+
+#endif /* RTS_HIST_H */
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_job_pool.h
+ * @brief Slab allocator for rts_job.
+ *
+ * Jobs are carved out of cache-line-aligned slabs and recycled through a
+ * free list, so releases and completions never touch malloc once the pool
+ * has grown to the peak number of live jobs.
+ */
+#ifndef RTS_JOB_POOL_H
+#define RTS_JOB_POOL_H
+
+#include "rts_types.h"
+
+/* Slab alignment, one cache line */
+#define RTS_JOB_POOL_ALIGN 64
+
+/* Jobs carved out of each slab */
+#define RTS_JOB_POOL_SLAB_JOBS 256
+
+/**
+ * rts_job_pool_init - initialize an empty pool
+ * @pool: job pool
+ */
+void rts_job_pool_init(struct rts_job_pool *pool);
+
+/**
+ * rts_job_pool_alloc - take a zeroed job from the pool
+ * @pool: job pool
+ *
+ * Returns NULL if a new slab was needed and could not be allocated.
+ */
+struct rts_job *rts_job_pool_alloc(struct rts_job_pool *pool);
+
+/**
+ * rts_job_pool_free - return a job to the pool
+ * @pool: job pool
+ * @job:  job previously returned by rts_job_pool_alloc(), no longer queued
+ */
+void rts_job_pool_free(struct rts_job_pool *pool, struct rts_job *job);
+
+/**
+ * rts_job_pool_destroy - release every slab at once
+ * @pool: job pool
+ *
+ * All jobs handed out by the pool become invalid, whether or not they were
+ * returned.  Cost is proportional to the number of slabs, not jobs.
+ */
+void rts_job_pool_destroy(struct rts_job_pool *pool);
+
+#endif /* RTS_JOB_POOL_H */
@@ -2,10 +2,22 @@
 /**
  * @file rts_log.h
  * @brief Logging macros with color support.
+ *
+ * Console output is filtered by verbosity:
+ *   - summary: banner and final counters only
+ *   - events:  also arrivals, completions and deadline misses
+ *   - full:    also the running job and ready queue on every step
+ *
+ * Records above RTS_LOG_MAX_LEVEL are compiled out entirely, so release
+ * builds pay nothing for the per-tick dump.  A log may be asynchronous:
+ * records are formatted by the caller and handed through a lock-free
+ * single-producer/single-consumer ring to a writer thread, so the
+ * simulation loop never waits on terminal or pipe I/O.
  */
 #ifndef RTS_LOG_H
 #define RTS_LOG_H
 
+#include <inttypes.h>
 #include <stdio.h>
 
 /* Console Colors */
@@ -25,31 +37,105 @@
     #define ANSI_GRAY    ""
 #endif
 
+enum rts_log_level {
+	RTS_LOG_SUMMARY = 0,
+	RTS_LOG_EVENTS,
+	RTS_LOG_FULL,
+};
+
+/* Highest level compiled in (e.g., -DRTS_LOG_MAX_LEVEL=0 for release) */
+#ifndef RTS_LOG_MAX_LEVEL
+    #define RTS_LOG_MAX_LEVEL RTS_LOG_FULL
+#endif
+
+struct rts_log_ring;
+
+/**
+ * struct rts_log - console log sink
+ * @fp:    destination stream
+ * @level: highest enum rts_log_level written
+ * @ring:  asynchronous writer state (NULL: write @fp directly)
+ */
+struct rts_log {
+	FILE *fp;
+	int level;
+	struct rts_log_ring *ring;
+};
+
+/**
+ * rts_log_level_from_name - look up a level ("summary", "events", "full")
+ * Returns -1 if the name is unknown.
+ */
+int rts_log_level_from_name(const char *name);
+
+/**
+ * rts_log_open - set up a log sink
+ * @log:   sink to initialize
+ * @fp:    destination stream
+ * @level: enum rts_log_level
+ * @async: nonzero to write from a background thread
+ *
+ * Falls back to synchronous writes if the writer thread cannot start.
+ * Returns 0 on success, -1 if the ring could not be allocated.
+ */
+int rts_log_open(struct rts_log *log, FILE *fp, int level, int async);
+
+/**
+ * rts_log_close - drain pending records, stop the writer and flush @fp
+ */
+void rts_log_close(struct rts_log *log);
+
+/**
+ * rts_log_sync - wait until every record so far has reached @fp
+ *
+ * Lets a caller write straight to @fp without overtaking queued records.
+ */
+void rts_log_sync(struct rts_log *log);
+
+/**
+ * rts_log_printf - format one record into @log
+ *
+ * Callers filter by level; use the RTS_LOG_* macros instead.
+ */
+void rts_log_printf(struct rts_log *log, const char *fmt, ...)
+	__attribute__((format(printf, 2, 3)));
+
+/* True if a record at @lvl reaches @log; constant-folds to 0 when compiled out */
+#define RTS_LOG_ENABLED(log, lvl) \
+    ((lvl) <= RTS_LOG_MAX_LEVEL && (log) && (lvl) <= (log)->level)
+
 /**
  * Log Macros
+ * @log: destination sink; NULL discards the record
  * Uses ##__VA_ARGS__ to handle cases with no format arguments
  */
-#define RTS_LOG_ARRIVAL(fmt, ...) \
-    printf(ANSI_CYAN "[ ARRIVAL ] " ANSI_RESET fmt, ##__VA_ARGS__)
+#define RTS_LOG_TO(log, lvl, fmt, ...) \
+    do { if (RTS_LOG_ENABLED(log, lvl)) rts_log_printf((log), fmt, ##__VA_ARGS__); } while (0)
+
+#define RTS_LOG_INFO(log, fmt, ...) \
+    RTS_LOG_TO(log, RTS_LOG_SUMMARY, fmt, ##__VA_ARGS__)
+
+#define RTS_LOG_ARRIVAL(log, fmt, ...) \
+    RTS_LOG_TO(log, RTS_LOG_EVENTS, ANSI_CYAN "[ ARRIVAL ] " ANSI_RESET fmt, ##__VA_ARGS__)
 
-#define RTS_LOG_MISS(fmt, ...) \
-    printf(ANSI_RED "[ MISS ] " ANSI_RESET fmt, ##__VA_ARGS__)
+#define RTS_LOG_MISS(log, fmt, ...) \
+    RTS_LOG_TO(log, RTS_LOG_EVENTS, ANSI_RED "[ MISS ] " ANSI_RESET fmt, ##__VA_ARGS__)
 
-#define RTS_LOG_MISS_IMMINENT(fmt, ...) \
-    printf(ANSI_RED "[ MISS-IMMINENT ] " ANSI_RESET fmt, ##__VA_ARGS__)
+#define RTS_LOG_MISS_IMMINENT(log, fmt, ...) \
+    RTS_LOG_TO(log, RTS_LOG_EVENTS, ANSI_RED "[ MISS-IMMINENT ] " ANSI_RESET fmt, ##__VA_ARGS__)
 
-#define RTS_LOG_END(fmt, ...) \
-    printf(ANSI_GRAY "[ END-BOUNDARY ] " ANSI_RESET fmt, ##__VA_ARGS__)
+#define RTS_LOG_END(log, fmt, ...) \
+    RTS_LOG_TO(log, RTS_LOG_EVENTS, ANSI_GRAY "[ END-BOUNDARY ] " ANSI_RESET fmt, ##__VA_ARGS__)
 
-#define RTS_LOG_DONE(fmt, ...) \
-    printf(ANSI_GREEN "    → [DONE] " ANSI_RESET fmt, ##__VA_ARGS__)
+#define RTS_LOG_DONE(log, fmt, ...) \
+    RTS_LOG_TO(log, RTS_LOG_EVENTS, ANSI_GREEN "    → [DONE] " ANSI_RESET fmt, ##__VA_ARGS__)
 
-#define RTS_LOG_RUN(clock, fmt, ...) \
-    printf(ANSI_YELLOW "[ %03d ] " ANSI_RESET fmt, \
-           (clock), ##__VA_ARGS__)
+#define RTS_LOG_RUN(log, clock, fmt, ...) \
+    RTS_LOG_TO(log, RTS_LOG_FULL, ANSI_YELLOW "[ %03" PRId64 " ] " ANSI_RESET fmt, \
+               (int64_t)(clock), ##__VA_ARGS__)
 
 /**
- * Debug macro: Can be disabled by not defining RTS_DEBUG 
+ * Debug macro: Can be disabled by not defining RTS_DEBUG
  */
 #ifdef RTS_DEBUG
     #define RTS_LOG_DEBUG(fmt, ...) \
@@ -4,6 +4,15 @@
  * @brief Task set parser interface.
  *
  * Defines the public functions for loading task sets from files.
+ *
+ * Two formats are accepted, told apart by the first bytes of the file:
+ *   - text:   one "phase period deadline wcet" line per task; commas may
+ *             separate the fields, lines starting with '#' are comments
+ *   - binary: RTS_TASKSET_MAGIC followed by RTS_TASKSET_REC_LEN-byte
+ *             little-endian records: int32 phase, int32 period,
+ *             int32 deadline, int32 wcet
+ * Either is mapped into memory and scanned once, so loading costs one
+ * pass over the file.
  */
 
 #ifndef RTS_PARSER_H
@@ -11,13 +20,34 @@
 
 #include "rts_types.h"
 
+#include <stdio.h>
+
+/* Binary task set file header */
+#define RTS_TASKSET_MAGIC     "RTSTSK1"
+#define RTS_TASKSET_MAGIC_LEN 8
+#define RTS_TASKSET_REC_LEN   16
+
 /**
  * rts_parser_load_tasks - load task set from file
  * @path: file path
  * @n_tasks_out: output number of tasks
  *
  * Each line format: phase period deadline wcet
+ *
+ * Lines (or records) that do not hold four integers, or whose period or
+ * wcet is not positive, are skipped.  Returns a malloc'd array, or NULL
+ * if the file cannot be read or a binary file is truncated.
  */
 struct rts_task *rts_parser_load_tasks(const char *path, int *n_tasks_out);
 
+/**
+ * rts_parser_write_binary - write a task set in the binary format
+ * @fp:      destination, opened in binary mode
+ * @tasks:   task set
+ * @n_tasks: number of tasks
+ *
+ * Returns 0 on success, -1 on a write error.
+ */
+int rts_parser_write_binary(FILE *fp, const struct rts_task *tasks, int n_tasks);
+
 #endif /* RTS_PARSER_H */
@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_partition.h
+ * @brief Partitioned multiprocessor scheduling.
+ *
+ * Tasks are statically assigned to M cores by a bin-packing heuristic and
+ * never migrate, so each core is an ordinary uniprocessor: it runs as an
+ * independent rts_sim on its own host thread.  A core admits a task only
+ * if its utilization stays at most 1 and the policy's schedulability test
+ * still passes for the tasks already placed there.
+ *
+ * Per-core traces are merged by rts_trace_merge() once every core has
+ * finished; task ids in the merged trace refer to the original task set.
+ */
+#ifndef RTS_PARTITION_H
+#define RTS_PARTITION_H
+
+#include "rts_types.h"
+
+#include <stdio.h>
+
+struct rts_rq_ops;
+struct rts_sched_class;
+
+enum rts_partition_fit {
+	RTS_PART_FFD = 0,	/* first core that admits the task */
+	RTS_PART_WFD,		/* least loaded core that admits it */
+	RTS_PART_BFD,		/* most loaded core that admits it */
+};
+
+/**
+ * struct rts_partition_core - one core and the tasks bound to it
+ * @tasks:       private copies, tids renumbered 0..n_tasks-1
+ * @gtid:        original tid of each local task
+ * @n_tasks:     number of tasks on this core
+ * @util:        total utilization
+ * @total_jobs:  jobs released by the last run
+ * @missed_jobs: deadline misses in the last run
+ * @preemptions: preemptions in the last run
+ * @switches:    context switches in the last run
+ * @overhead:    switch time charged in the last run
+ * @cycle_start: with steady runs, first boundary of the repeating schedule
+ * @cycle_len:   with steady runs, its length (0: no repetition found)
+ * @ms:          wall time of the last run
+ * @trace:       interval trace of the last run (NULL: none)
+ */
+struct rts_partition_core {
+	struct rts_task *tasks;
+	int *gtid;
+	int n_tasks;
+	double util;
+
+	int64_t total_jobs;
+	int64_t missed_jobs;
+	long preemptions;
+	long switches;
+	rts_time_t overhead;
+	rts_time_t cycle_start;
+	rts_time_t cycle_len;
+	double ms;
+	FILE *trace;
+};
+
+/**
+ * struct rts_partition - a task set split over several cores
+ * @cores:    per-core state
+ * @n_cores:  number of cores
+ * @n_forced: tasks no core admitted, placed on the least loaded core
+ */
+struct rts_partition {
+	struct rts_partition_core *cores;
+	int n_cores;
+	int n_forced;
+};
+
+/**
+ * struct rts_partition_opts - how every core is simulated
+ * @rq_ops: ready queue backend (NULL: the policy's default)
+ * @engine: enum rts_engine
+ * @steady: stop each core once its schedule repeats
+ * @trace:  record per-core traces for rts_partition_merge_trace()
+ * @report: stream receiving one JSON report per core (NULL: none)
+ * @switch_cost: time charged per preemption on every core (0: free)
+ * @task_stats: per-task timing histograms indexed by original tid, filled
+ *          in by the run (NULL: off)
+ */
+struct rts_partition_opts {
+	const struct rts_rq_ops *rq_ops;
+	int engine;
+	int steady;
+	int trace;
+	FILE *report;
+	int switch_cost;
+	struct rts_task_stats *task_stats;
+};
+
+/**
+ * rts_partition_fit_from_name - look up a heuristic ("ffd", "wfd", "bfd")
+ * Returns -1 if the name is unknown.
+ */
+int rts_partition_fit_from_name(const char *name);
+
+/**
+ * rts_partition_assign - bin-pack a task set onto cores
+ * @part:    partition to fill
+ * @tasks:   task set
+ * @n_tasks: number of tasks
+ * @n_cores: number of cores
+ * @fit:     enum rts_partition_fit
+ * @sched:   policy whose schedulability test guards each core
+ *
+ * Tasks are placed in order of decreasing utilization.  A task that fits
+ * nowhere is still placed on the least loaded core, so the simulation
+ * shows where it misses, and counted in @part->n_forced.
+ *
+ * Returns 0 on success, -1 on allocation failure.
+ */
+int rts_partition_assign(struct rts_partition *part,
+                         const struct rts_task *tasks, int n_tasks,
+                         int n_cores, int fit,
+                         const struct rts_sched_class *sched);
+
+/**
+ * rts_partition_print - list the tasks bound to each core
+ */
+void rts_partition_print(const struct rts_partition *part, FILE *out);
+
+/**
+ * rts_partition_run - simulate every non-empty core on its own thread
+ * @part:      assigned partition; per-core results are filled in
+ * @sched:     policy used on every core
+ * @opts:      simulation options
+ * @lcm:       hyperperiod of the whole task set
+ * @max_phase: max phase offset of the whole task set
+ *
+ * All cores cover the same horizon, so their traces line up.  Falls back
+ * to the calling thread for cores whose thread cannot be created.
+ */
+void rts_partition_run(struct rts_partition *part,
+                       const struct rts_sched_class *sched,
+                       const struct rts_partition_opts *opts,
+                       rts_time_t lcm, rts_time_t max_phase);
+
+/**
+ * rts_partition_collect - copy per-task counters of the last run back
+ * @part:  partition after rts_partition_run()
+ * @tasks: the task set @part was assigned from
+ *
+ * Fills in release_count, preemptions and migrations (always 0: tasks
+ * never leave their core).
+ */
+void rts_partition_collect(const struct rts_partition *part, struct rts_task *tasks);
+
+/**
+ * rts_partition_merge_trace - write the per-core traces as one trace
+ * @part: partition after rts_partition_run() with tracing on
+ * @out:  destination
+ * @fmt:  RTS_TRACE_TICK or RTS_TRACE_INTERVAL
+ *
+ * Returns 0 on success, -1 if a per-core trace cannot be read back.
+ */
+int rts_partition_merge_trace(const struct rts_partition *part, FILE *out, int fmt);
+
+/**
+ * rts_partition_destroy - release every core
+ */
+void rts_partition_destroy(struct rts_partition *part);
+
+#endif /* RTS_PARTITION_H */
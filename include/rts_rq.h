@@ -8,10 +8,17 @@
 #ifndef RTS_RQ_H
 #define RTS_RQ_H
 
+#include "rts_sched.h"
+#include "rts_stats.h"
+#include "rts_types.h"
+
+#include <stdio.h>
+
 struct rts_list_head;
 struct rts_job;
 struct rts_task;
 struct rts_sched_class;
+struct rts_log;
 
 void rts_rq_init(struct rts_list_head *head);
 
@@ -21,14 +28,176 @@ struct rts_job *rts_rq_dequeue(struct rts_list_head *rq);
 
 void rts_rq_remove(struct rts_job *job);
 
-/* Ordered insert according to scheduler policy */
-void rts_rq_ordered_insert(struct rts_list_head *head,
-                           struct rts_job *job,
-                           const struct rts_sched_class *sched,
-                           const struct rts_task *tasks,
-                           int now);
-
 /* Debug print */
-void rts_rq_dump(struct rts_list_head *head, const struct rts_task *tasks);
+void rts_rq_dump(struct rts_log *log, struct rts_list_head *head, const struct rts_task *tasks);
+void rts_rq_dump_job(struct rts_log *log, const struct rts_job *job);
+
+/**
+ * struct rts_rq_ops - ready queue backend interface
+ * @name:    backend name (e.g., "list", "heap")
+ * @init:    allocate backend state; return 0 on success
+ * @destroy: release backend state (queued jobs are not freed)
+ * @insert:  add a job
+ * @peek:    highest-priority job, or NULL if empty
+ * @pop:     remove and return the highest-priority job
+ * @remove:  remove a specific job
+ * @update:  restore order after a job's priority key changed
+ * @dump:    optional; print the queued jobs in priority order (NULL:
+ *           rq->jobs is in that order already)
+ */
+struct rts_rq_ops {
+	const char *name;
+	int (*init)(struct rts_rq *rq);
+	void (*destroy)(struct rts_rq *rq);
+	void (*insert)(struct rts_rq *rq, struct rts_job *job);
+	struct rts_job *(*peek)(struct rts_rq *rq);
+	struct rts_job *(*pop)(struct rts_rq *rq);
+	void (*remove)(struct rts_rq *rq, struct rts_job *job);
+	void (*update)(struct rts_rq *rq, struct rts_job *job);
+	void (*dump)(struct rts_rq *rq, struct rts_log *log);
+};
+
+extern const struct rts_rq_ops rts_rq_list_ops;
+extern const struct rts_rq_ops rts_rq_heap_ops;
+extern const struct rts_rq_ops rts_rq_lst_ops;
+
+/*
+ * Copies of the list and heap backends for each built-in priority order,
+ * e.g. rts_rq_heap_edf_ops; rts_rq_setup() swaps them in.  They share
+ * the generic backend's name.
+ */
+#define RTS_RQ_VARIANT_DECL(NAME, name)                  \
+	extern const struct rts_rq_ops rts_rq_list_##name##_ops; \
+	extern const struct rts_rq_ops rts_rq_heap_##name##_ops;
+RTS_PRIO_BUILTIN(RTS_RQ_VARIANT_DECL)
+#undef RTS_RQ_VARIANT_DECL
+
+/**
+ * Factory method to look up a ready queue backend by name.
+ */
+const struct rts_rq_ops *rts_rq_ops_from_name(const char *name);
+
+/**
+ * rts_rq_setup - bind a ready queue to a backend and scheduler
+ * @rq:    ready queue
+ * @ops:   backend (NULL selects @sched's preferred backend, else the list)
+ * @sched: scheduler class defining higher_prio()
+ * @tasks: task set
+ * @clock: simulation clock
+ *
+ * The generic list and heap are replaced by their copy specialized for
+ * @sched's built-in order, if it has one.
+ *
+ * Returns 0 on success, -1 if the backend could not allocate its state.
+ */
+int rts_rq_setup(struct rts_rq *rq,
+                 const struct rts_rq_ops *ops,
+                 const struct rts_sched_class *sched,
+                 const struct rts_task *tasks,
+                 const rts_time_t *clock);
+
+/*
+ * Deadline index (rts_rq_deadline.c).  A queued job with work left is late
+ * at time t, i.e. past its deadline or unable to meet it, iff
+ * t > abs_deadline - remain, so the jobs to drop are exactly those at the
+ * top of a min-heap on that key.  The wrappers below keep it in step with
+ * the backend; only the running job's key changes while it is queued, and
+ * rts_rq_update() covers that.
+ */
+int rts_rq_dl_init(struct rts_rq *rq);
+void rts_rq_dl_destroy(struct rts_rq *rq);
+void rts_rq_dl_insert(struct rts_rq *rq, struct rts_job *job);
+void rts_rq_dl_remove(struct rts_rq *rq, struct rts_job *job);
+void rts_rq_dl_update(struct rts_rq *rq, struct rts_job *job);
+
+/**
+ * rts_rq_dl_first - queued job with the earliest latest feasible start,
+ * or NULL if the queue is empty
+ *
+ * Ties go to the earlier release, then the lower TID and job index.
+ */
+static inline struct rts_job *rts_rq_dl_first(const struct rts_rq *rq) {
+	return rq->dl_nr ? rq->dl[0] : NULL;
+}
+
+/**
+ * rts_rq_dl_next - earliest latest feasible start among queued jobs other
+ * than @skip (NULL: none skipped), or RTS_TIME_MAX if there is none
+ */
+rts_time_t rts_rq_dl_next(const struct rts_rq *rq, const struct rts_job *skip);
+
+/**
+ * rts_rq_higher - the policy's higher_prio() for backends, counted in
+ * rq->stats
+ */
+static inline int rts_rq_higher(const struct rts_rq *rq,
+                                const struct rts_job *a,
+                                const struct rts_job *b) {
+	rts_stats_cmp(rq->stats);
+	return rq->sched->higher_prio(a, b, rq->tasks, *rq->clock);
+}
+
+/*
+ * rts_rq_higher_rm() etc. - the same for built-in orders, with the
+ * comparison inlined
+ */
+#define RTS_RQ_HIGHER_FN(NAME, name)                                      \
+	static inline int rts_rq_higher_##name(const struct rts_rq *rq,    \
+	                                       const struct rts_job *a,    \
+	                                       const struct rts_job *b) {  \
+		rts_stats_cmp(rq->stats);                                  \
+		return rts_prio_##name(a, b, rq->tasks, *rq->clock);       \
+	}
+RTS_PRIO_BUILTIN(RTS_RQ_HIGHER_FN)
+#undef RTS_RQ_HIGHER_FN
+
+static inline void rts_rq_destroy(struct rts_rq *rq) {
+	rq->ops->destroy(rq);
+	rts_rq_dl_destroy(rq);
+}
+
+static inline void rts_rq_insert(struct rts_rq *rq, struct rts_job *job) {
+#ifdef RTS_STATS
+	uint64_t cmps = rq->stats ? rq->stats->prio_cmps : 0;
+
+	rq->ops->insert(rq, job);
+	rts_stats_enqueue(rq->stats, cmps);
+#else
+	rq->ops->insert(rq, job);
+#endif
+	rts_rq_dl_insert(rq, job);
+}
+
+static inline struct rts_job *rts_rq_peek(struct rts_rq *rq) {
+	return rq->ops->peek(rq);
+}
+
+static inline struct rts_job *rts_rq_pop(struct rts_rq *rq) {
+	struct rts_job *job = rq->ops->pop(rq);
+
+	if (job) {
+		rts_rq_dl_remove(rq, job);
+		rts_stats_dequeue(rq->stats);
+	}
+	return job;
+}
+
+static inline void rts_rq_erase(struct rts_rq *rq, struct rts_job *job) {
+	rq->ops->remove(rq, job);
+	rts_rq_dl_remove(rq, job);
+	rts_stats_dequeue(rq->stats);
+}
+
+static inline void rts_rq_update(struct rts_rq *rq, struct rts_job *job) {
+	rq->ops->update(rq, job);
+	rts_rq_dl_update(rq, job);
+}
+
+static inline void rts_rq_print(struct rts_rq *rq, struct rts_log *log) {
+	if (rq->ops->dump)
+		rq->ops->dump(rq, log);
+	else
+		rts_rq_dump(log, &rq->jobs, rq->tasks);
+}
 
 #endif /* RTS_RQ_H */
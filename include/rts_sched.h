@@ -8,9 +8,124 @@
 #ifndef RTS_SCHED_H
 #define RTS_SCHED_H
 
+#include "rts_types.h"
+
+#include <stdio.h>
+
 struct rts_sim;
 struct rts_job;
 struct rts_task;
+struct rts_rq;
+struct rts_rq_ops;
+
+/*
+ * Built-in priority orders, X(NAME, name): the ready queues carry a copy
+ * of their list and heap backends for each, with the comparison below
+ * inlined instead of called through higher_prio().
+ */
+#define RTS_PRIO_BUILTIN(X) \
+	X(RM, rm)           \
+	X(EDF, edf)         \
+	X(LST, lst)         \
+	X(NP_RM, np_rm)     \
+	X(NP_EDF, np_edf)   \
+	X(RM_PT, rm_pt)
+
+/**
+ * enum rts_prio - how a class orders jobs
+ * @RTS_PRIO_CUSTOM: only through its higher_prio() (user-registered
+ *                   classes)
+ * @RTS_PRIO_RM, @RTS_PRIO_EDF, @RTS_PRIO_LST, @RTS_PRIO_NP_RM,
+ * @RTS_PRIO_NP_EDF, @RTS_PRIO_RM_PT: like rts_prio_rm() etc., which
+ *                   higher_prio() must agree with
+ */
+enum rts_prio {
+	RTS_PRIO_CUSTOM = 0,
+#define RTS_PRIO_ENUM(NAME, name) RTS_PRIO_##NAME,
+	RTS_PRIO_BUILTIN(RTS_PRIO_ENUM)
+#undef RTS_PRIO_ENUM
+	RTS_PRIO_NR,
+};
+
+/* Shorter period first, then lower TID */
+static inline int rts_prio_rm(const struct rts_job *a, const struct rts_job *b,
+                              const struct rts_task *tasks, rts_time_t now) {
+	(void)now;
+
+	if (tasks[a->tid].period == tasks[b->tid].period)
+		return a->tid < b->tid;
+	return tasks[a->tid].period < tasks[b->tid].period;
+}
+
+/* Earlier absolute deadline first, then lower TID */
+static inline int rts_prio_edf(const struct rts_job *a, const struct rts_job *b,
+                               const struct rts_task *tasks, rts_time_t now) {
+	(void)tasks;
+	(void)now;
+
+	if (a->abs_deadline == b->abs_deadline)
+		return a->tid < b->tid;
+	return a->abs_deadline < b->abs_deadline;
+}
+
+/* Less slack at @now first, then lower TID */
+static inline int rts_prio_lst(const struct rts_job *a, const struct rts_job *b,
+                               const struct rts_task *tasks, rts_time_t now) {
+	(void)tasks;
+
+	rts_time_t slack_a = a->abs_deadline - now - a->remain;
+	rts_time_t slack_b = b->abs_deadline - now - b->remain;
+
+	if (slack_a == slack_b)
+		return a->tid < b->tid;
+	return slack_a < slack_b;
+}
+
+/*
+ * Limited preemption is an order too: a job that has started competes with
+ * a boosted priority, so a queued job outranks it only if it clears that
+ * boost.  Starting only ever raises the job being dispatched, which is
+ * already first, so no queue has to reorder when it happens.
+ */
+static inline int rts_job_started(const struct rts_job *j) {
+	return j->start >= 0;
+}
+
+/* Started job first (it runs to completion), then like rts_prio_rm() */
+static inline int rts_prio_np_rm(const struct rts_job *a, const struct rts_job *b,
+                                 const struct rts_task *tasks, rts_time_t now) {
+	if (rts_job_started(a) != rts_job_started(b))
+		return rts_job_started(a);
+	return rts_prio_rm(a, b, tasks, now);
+}
+
+/* Started job first (it runs to completion), then like rts_prio_edf() */
+static inline int rts_prio_np_edf(const struct rts_job *a, const struct rts_job *b,
+                                  const struct rts_task *tasks, rts_time_t now) {
+	if (rts_job_started(a) != rts_job_started(b))
+		return rts_job_started(a);
+	return rts_prio_edf(a, b, tasks, now);
+}
+
+/*
+ * Preemption thresholds: a job ranks at its task's pt_rank until it
+ * starts and at its pt_threshold from then on; on a tie the started one
+ * keeps the processor, then lower TID
+ */
+static inline int rts_prio_rm_pt(const struct rts_job *a, const struct rts_job *b,
+                                 const struct rts_task *tasks, rts_time_t now) {
+	(void)now;
+
+	const struct rts_task *ta = &tasks[a->tid], *tb = &tasks[b->tid];
+	int ra = rts_job_started(a) ? ta->pt_threshold : ta->pt_rank;
+	int rb = rts_job_started(b) ? tb->pt_threshold : tb->pt_rank;
+
+	if (ra != rb)
+		return ra < rb;
+	if (rts_job_started(a) != rts_job_started(b))
+		return rts_job_started(a);
+	return a->tid < b->tid;
+}
 
 /**
  * struct rts_sched_class - scheduler strategy interface
@@ -18,24 +133,77 @@ struct rts_task;
  * @higher_prio: return 1 if job a has higher priority than b
  * @enqueue: insert job into ready queue (default: ordered insert)
  * @tick:    optional tick handler (for RR)
- * @schedulability_test: optional static test before simulation
+ * @schedulability_test: optional static test before simulation; prints
+ *                       its verdict to @out (NULL: silent) and returns 1
+ *                       if the task set passes
+ * @analyze: optional exact analysis usable instead of simulating; prints
+ *           per-task details to @out (NULL: silent) and returns 1 if the
+ *           task set is schedulable, 0 if not
+ * @preempt_at: optional; earliest time at which any job waiting in @rq
+ *              may outrank running job @cur (RTS_TIME_MAX: none).  Called
+ *              at every event, so it should use the queue's indexes
+ *              rather than walk it.  Only needed when priorities change
+ *              with time (e.g. LST); static-priority classes leave it
+ *              NULL.
+ * @prepare: optional; derive per-task state the order depends on (e.g.
+ *           preemption thresholds) from the task set before a run.
+ *           Returns 0 on success, -1 if it runs out of memory.
+ * @rq_ops: optional ready queue backend specialized for this class, used
+ *          unless one is chosen explicitly
+ * @prio:   enum rts_prio; a built-in order lets the queues and the global
+ *          dispatcher compare jobs without calling @higher_prio
  */
 struct rts_sched_class {
 	const char *name;
 	int (*higher_prio)(const struct rts_job *a,
 	                   const struct rts_job *b,
 	                   const struct rts_task *tasks,
-	                   int now);
+	                   rts_time_t now);
 	void (*enqueue)(struct rts_sim *sim, struct rts_job *job);
 	void (*tick)(struct rts_sim *sim);
-	int (*schedulability_test)(const struct rts_task *tasks, int n_tasks);
+	int (*schedulability_test)(const struct rts_task *tasks, int n_tasks, FILE *out);
+	int (*analyze)(const struct rts_task *tasks, int n_tasks, FILE *out);
+	rts_time_t (*preempt_at)(const struct rts_job *cur,
+	                         const struct rts_rq *rq,
+	                         const struct rts_task *tasks,
+	                         rts_time_t now);
+	int (*prepare)(struct rts_task *tasks, int n_tasks);
+	const struct rts_rq_ops *rq_ops;
+	int prio;
 };
 
+/**
+ * rts_sched_higher - @sched's higher_prio(), inlined for built-in orders
+ *
+ * For callers outside the specialized queues, which compare rarely
+ * enough that one predictable branch is cheaper than the call.
+ */
+static inline int rts_sched_higher(const struct rts_sched_class *sched,
+                                   const struct rts_job *a,
+                                   const struct rts_job *b,
+                                   const struct rts_task *tasks,
+                                   rts_time_t now) {
+	switch (sched->prio) {
+#define RTS_PRIO_CASE(NAME, name) \
+	case RTS_PRIO_##NAME:     \
+		return rts_prio_##name(a, b, tasks, now);
+	RTS_PRIO_BUILTIN(RTS_PRIO_CASE)
+#undef RTS_PRIO_CASE
+	default:
+		return sched->higher_prio(a, b, tasks, now);
+	}
+}
+
 /**
  * Factory method to look up a scheduler by name.
  */
 const struct rts_sched_class *rts_sched_from_name(const char *name);
 
+/**
+ * rts_sched_list - NULL-terminated table of every registered scheduler
+ */
+const struct rts_sched_class * const *rts_sched_list(void);
+
 void rts_sched_default_enqueue(struct rts_sim *sim,
                                struct rts_job *job,
                                const struct rts_sched_class *sched);
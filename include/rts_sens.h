@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_sens.h
+ * @brief Sensitivity analysis: critical WCET scaling factor per policy.
+ *
+ * The critical scaling factor is the largest alpha such that the task set
+ * stays schedulable when every WCET (or one task's) becomes
+ * ceil(alpha * C); the utilization at that point is the breakdown
+ * utilization.  The factor is found by bisection, each probe settled by:
+ *   - the rounded WCETs' utilization, which fails the probe above 1;
+ *   - the policy's exact analysis (rts_sched_class::analyze), when it has
+ *     one, every task is released at time 0, where it is exact, and
+ *     preemptions cost nothing;
+ *   - otherwise a simulation over the usual horizon that stops at the
+ *     first deadline miss.
+ *
+ * One context keeps a scratch copy of the task set whose WCETs are
+ * rewritten for every probe, so a search allocates nothing per iteration
+ * and several policies can be searched on the same parsed tasks.
+ */
+#ifndef RTS_SENS_H
+#define RTS_SENS_H
+
+#include "rts_types.h"
+
+struct rts_rq_ops;
+struct rts_sched_class;
+
+/* Scale every task's WCET */
+#define RTS_SENS_ALL -1
+
+/* Bisection stops once the bracket is this small relative to its start */
+#define RTS_SENS_EPS 1e-4
+
+/**
+ * struct rts_sens - sensitivity search context
+ * @tasks:     task set as parsed; never modified
+ * @scaled:    scratch copy with scaled WCETs
+ * @n_tasks:   number of tasks
+ * @target:    index of the task to scale, or RTS_SENS_ALL
+ * @rq_ops:    ready queue backend for simulated probes (NULL: default)
+ * @lcm:       hyperperiod; does not depend on WCETs
+ * @max_phase: largest release offset
+ * @sim_ok:    the horizon fits the time range, so probes can simulate
+ * @sync:      every phase is 0, so analytic tests are exact
+ * @switch_cost: time charged per preemption in simulated probes; set it
+ *             after rts_sens_init() (0: free)
+ */
+struct rts_sens {
+	const struct rts_task *tasks;
+	struct rts_task *scaled;
+	int n_tasks;
+	int target;
+	const struct rts_rq_ops *rq_ops;
+	rts_time_t lcm;
+	rts_time_t max_phase;
+	int sim_ok;
+	int sync;
+	int switch_cost;
+};
+
+/**
+ * struct rts_sens_result - outcome of one policy's search
+ * @factor:   largest scaling found schedulable (0: none, down to
+ *            RTS_SENS_EPS * @limit)
+ * @util:     breakdown utilization, i.e. total utilization at @factor
+ * @limit:    upper end of the search, where utilization reaches 1
+ * @probes:   schedulability checks performed
+ * @analytic: probes used the policy's analysis instead of simulating
+ */
+struct rts_sens_result {
+	double factor;
+	double util;
+	double limit;
+	int probes;
+	int analytic;
+};
+
+/**
+ * rts_sens_init - prepare a search over @tasks
+ * @s:       context
+ * @tasks:   task set, kept by reference
+ * @n_tasks: number of tasks
+ * @target:  task index whose WCET is scaled, or RTS_SENS_ALL
+ * @rq_ops:  ready queue backend for simulated probes (NULL: default)
+ *
+ * Returns 0 on success, -1 on a bad target or allocation failure.
+ */
+int rts_sens_init(struct rts_sens *s, const struct rts_task *tasks, int n_tasks,
+                  int target, const struct rts_rq_ops *rq_ops);
+
+/**
+ * rts_sens_destroy - release the scratch task set
+ */
+void rts_sens_destroy(struct rts_sens *s);
+
+/**
+ * rts_sens_search - bisect the critical scaling factor under @sched
+ * @s:     context
+ * @sched: policy
+ * @res:   output
+ *
+ * Returns 0 on success, -1 if a probe would have to simulate but the
+ * horizon does not fit the time range.
+ */
+int rts_sens_search(struct rts_sens *s, const struct rts_sched_class *sched,
+                    struct rts_sens_result *res);
+
+#endif /* RTS_SENS_H */
@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_sim.h
+ * @brief Simulation engine interface.
+ *
+ * Two engines are provided and produce identical misses, job counts and
+ * trace content:
+ *   - tick:  advances the clock one time unit per iteration
+ *   - event: jumps straight to the next release, completion, deadline
+ *            check or priority change
+ */
+#ifndef RTS_SIM_H
+#define RTS_SIM_H
+
+#include "rts_types.h"
+
+struct rts_sim;
+struct rts_sched_class;
+struct rts_task;
+
+enum rts_engine {
+	RTS_ENGINE_TICK = 0,
+	RTS_ENGINE_EVENT,
+};
+
+/*
+ * Steady-state runs give up this many hyperperiods past the largest phase.
+ * Backlogged task sets (deadlines beyond the period, overload) may need
+ * several hyperperiods to settle.
+ */
+#define RTS_SIM_STEADY_MAX_CYCLES 16
+
+/**
+ * struct rts_hooks - callbacks on simulation events
+ * @release:  @job was released at @t
+ * @dispatch: @job got a CPU at @t: its first run, or resuming after
+ *            another job ran
+ * @complete: @job finished at @t
+ * @miss:     @job missed, or can no longer meet, its deadline at @t and
+ *            is dropped
+ * @ctx:      passed to every callback
+ *
+ * Any callback may be NULL.  @job is valid only during the call.
+ */
+struct rts_hooks {
+	void (*release)(void *ctx, const struct rts_job *job, rts_time_t t);
+	void (*dispatch)(void *ctx, const struct rts_job *job, rts_time_t t);
+	void (*complete)(void *ctx, const struct rts_job *job, rts_time_t t);
+	void (*miss)(void *ctx, const struct rts_job *job, rts_time_t t);
+	void *ctx;
+};
+
+/**
+ * rts_engine_from_name - look up an engine by name ("tick", "event")
+ * Returns -1 if the name is unknown.
+ */
+int rts_engine_from_name(const char *name);
+
+/**
+ * rts_sim_horizon - hyperperiod and largest phase of a task set
+ * @tasks:     task set
+ * @n_tasks:   number of tasks
+ * @lcm:       output hyperperiod
+ * @max_phase: output max phase offset
+ * @steady:    nonzero if the run will use steady-state detection
+ *
+ * The simulation covers [0, lcm + max_phase], or up to
+ * [0, max_phase + RTS_SIM_STEADY_MAX_CYCLES * lcm] in steady-state mode.
+ *
+ * Returns 0 on success, -1 if the hyperperiod overflows or that span (plus
+ * any deadline reached from it) does not fit in rts_time_t.
+ */
+int rts_sim_horizon(const struct rts_task *tasks, int n_tasks,
+                    rts_time_t *lcm, rts_time_t *max_phase, int steady);
+
+/**
+ * rts_sim_start - prepare a uniprocessor simulation for rts_sim_step()
+ * @sim:   simulation context; its clock is the start time and the task
+ *         set's release state must be fresh
+ * @sched: chosen scheduler class
+ *
+ * Returns 0 on success, -1 if the queues cannot be set up.
+ */
+int rts_sim_start(struct rts_sim *sim, const struct rts_sched_class *sched);
+
+/**
+ * rts_sim_resume - like rts_sim_start(), but keep every task's
+ * next_release and check nothing, for state restored between two steps
+ *
+ * The ready queue starts empty; the caller inserts the saved jobs, taken
+ * from @sim->job_pool.
+ */
+int rts_sim_resume(struct rts_sim *sim, const struct rts_sched_class *sched);
+
+/**
+ * rts_sim_step - advance a started simulation by one decision
+ * @sim:    simulation context
+ * @sched:  scheduler class it was started with
+ * @engine: enum rts_engine; tick moves one time unit, event up to the
+ *          next release, completion or priority change
+ * @until:  never advance past this time; must be > sim->clock
+ *
+ * Releases the jobs due at the clock, runs the selected one, then drops
+ * the jobs that are late at the new clock.
+ */
+void rts_sim_step(struct rts_sim *sim, const struct rts_sched_class *sched,
+                  int engine, rts_time_t until);
+
+/**
+ * rts_sim_finish - release the queues of a started simulation
+ */
+void rts_sim_finish(struct rts_sim *sim);
+
+/**
+ * rts_sim_run - tick-driven simulation loop
+ * @sim: simulation context
+ * @sched: chosen scheduler class
+ * @lcm: total hyperperiod
+ * @max_phase: max phase offset
+ *
+ * With sim->steady set, the state is sampled at every multiple of @lcm
+ * and the run stops at the first repeat, or after RTS_SIM_STEADY_MAX_CYCLES
+ * hyperperiods past @max_phase.
+ */
+void rts_sim_run(struct rts_sim *sim,
+                 const struct rts_sched_class *sched,
+                 rts_time_t lcm, rts_time_t max_phase);
+
+/**
+ * rts_sim_run_event - discrete-event simulation loop
+ *
+ * Same parameters and results as rts_sim_run().
+ */
+void rts_sim_run_event(struct rts_sim *sim,
+                       const struct rts_sched_class *sched,
+                       rts_time_t lcm, rts_time_t max_phase);
+
+/**
+ * rts_sim_run_lockstep - simulate several policies over one arrival stream
+ * @sims:      one context per policy; all share the same task array
+ * @scheds:    policy of each context
+ * @n:         number of policies
+ * @engine:    enum rts_engine
+ * @lcm:       total hyperperiod
+ * @max_phase: max phase offset
+ *
+ * Per-policy results and traces match separate runs of the same engine.
+ */
+void rts_sim_run_lockstep(struct rts_sim *sims,
+                          const struct rts_sched_class *const *scheds,
+                          int n, int engine,
+                          rts_time_t lcm, rts_time_t max_phase);
+
+/**
+ * rts_sim_run_global - global multiprocessor scheduling
+ * @sim:       simulation context; @sim->trace, if set, points to one
+ *             writer per CPU
+ * @sched:     policy; job priorities must not change over time (G-EDF,
+ *             G-RM), i.e. @sched->preempt_at is NULL
+ * @n_cpus:    number of CPUs
+ * @engine:    enum rts_engine
+ * @lcm:       total hyperperiod
+ * @max_phase: max phase offset
+ *
+ * One ready queue feeds all CPUs: at every step the @n_cpus
+ * highest-priority jobs run.  Jobs switched out unfinished count as
+ * preempted and jobs resuming on another CPU as migrated, both in @sim
+ * and per task.  Steady-state detection is not supported.
+ */
+void rts_sim_run_global(struct rts_sim *sim,
+                        const struct rts_sched_class *sched,
+                        int n_cpus, int engine,
+                        rts_time_t lcm, rts_time_t max_phase);
+
+#endif /* RTS_SIM_H */
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_snapshot.h
+ * @brief Saved uniprocessor simulation state.
+ *
+ * A snapshot holds everything rts_sim_step() reads between two steps: the
+ * clock, the counters, every task's release state and the queued jobs,
+ * including which one ran last.  Restoring it and stepping on gives the
+ * same schedule, events and counters as never having stopped.  Per-task
+ * histograms, traces and logs belong to the caller and are not saved.
+ *
+ * File format, all integers little-endian:
+ *   RTS_SNAPSHOT_MAGIC, then a header
+ *     char   sched[16], rq[16]      policy and backend names, NUL-padded
+ *     int32  engine, n_tasks, n_jobs, last, switch_cost
+ *     int64  clock, total_jobs, missed_jobs, preemptions, migrations,
+ *            switches, overhead, 8 x uint64 struct rts_stats
+ *   n_tasks records
+ *     int32  phase, period, rel_deadline, wcet, preemptions, migrations;
+ *     int64  release_count, next_release
+ *   n_jobs records, in ready-queue list order
+ *     int32  tid, jid, remain, cpu; int64 release_time, abs_deadline, start
+ */
+#ifndef RTS_SNAPSHOT_H
+#define RTS_SNAPSHOT_H
+
+#include "rts_sched.h"
+#include "rts_types.h"
+
+#include <stdio.h>
+
+#define RTS_SNAPSHOT_MAGIC     "RTSSNP3"
+#define RTS_SNAPSHOT_MAGIC_LEN 8
+#define RTS_SNAPSHOT_NAME_LEN  16
+
+/**
+ * struct rts_snapshot - state of a simulation between two steps
+ * @sched:       policy name
+ * @rq:          ready queue backend name ("": the policy's own)
+ * @engine:      enum rts_engine
+ * @clock:       simulation time
+ * @total_jobs:  jobs released
+ * @missed_jobs: jobs dropped as late
+ * @preemptions: jobs switched out before completing
+ * @migrations:  jobs resumed on another CPU
+ * @switch_cost: time charged per preemption
+ * @switches:    context switches
+ * @overhead:    time charged for preemptions
+ * @stats:       hot-path counters
+ * @n_tasks:     number of tasks
+ * @tasks:       task set with release state and counters
+ * @n_jobs:      number of queued jobs
+ * @jobs:        queued jobs, in ready-queue list order
+ * @last:        index in @jobs of the job that ran in the previous step
+ *               (-1: none)
+ */
+struct rts_snapshot {
+	char sched[RTS_SNAPSHOT_NAME_LEN];
+	char rq[RTS_SNAPSHOT_NAME_LEN];
+	int engine;
+
+	rts_time_t clock;
+	int64_t total_jobs;
+	int64_t missed_jobs;
+	long preemptions;
+	long migrations;
+	int switch_cost;
+	long switches;
+	rts_time_t overhead;
+	struct rts_stats stats;
+
+	int n_tasks;
+	struct rts_task *tasks;
+	int n_jobs;
+	struct rts_job *jobs;
+	int last;
+};
+
+/**
+ * rts_snapshot_take - copy the state of a started simulation
+ * @snap:   output, released with rts_snapshot_free()
+ * @sim:    simulation, between two steps
+ * @sched:  its policy
+ * @engine: enum rts_engine it is stepped with
+ *
+ * Costs O(n_tasks + queued jobs).  Returns 0 on success, -1 if memory
+ * runs out.
+ */
+int rts_snapshot_take(struct rts_snapshot *snap, const struct rts_sim *sim,
+                      const struct rts_sched_class *sched, int engine);
+
+/**
+ * rts_snapshot_restore - start @sim in the saved state
+ * @snap:  snapshot
+ * @sim:   simulation with tasks pointing to room for @snap->n_tasks
+ *         tasks and rq_ops, hooks and the output sinks set up; everything
+ *         else is overwritten
+ * @sched: policy named in @snap
+ *
+ * On success @sim is started as by rts_sim_start() and is released with
+ * rts_sim_finish().  Returns 0 on success, -1 if memory runs out.
+ */
+int rts_snapshot_restore(const struct rts_snapshot *snap, struct rts_sim *sim,
+                         const struct rts_sched_class *sched);
+
+/**
+ * rts_snapshot_write - write a snapshot in the file format above
+ *
+ * Returns 0 on success, -1 on a write error.
+ */
+int rts_snapshot_write(FILE *fp, const struct rts_snapshot *snap);
+
+/**
+ * rts_snapshot_read - read a snapshot written by rts_snapshot_write()
+ * @fp:   source, opened in binary mode
+ * @snap: output, released with rts_snapshot_free()
+ *
+ * Returns 0 on success, -1 if the file is truncated, malformed or memory
+ * runs out.
+ */
+int rts_snapshot_read(FILE *fp, struct rts_snapshot *snap);
+
+/**
+ * rts_snapshot_free - release the arrays of a snapshot
+ */
+void rts_snapshot_free(struct rts_snapshot *snap);
+
+#endif /* RTS_SNAPSHOT_H */
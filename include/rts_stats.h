@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_stats.h
+ * @brief Hot-path counters and the JSON run report.
+ *
+ * The counters in struct rts_stats are updated only when built with
+ * -DRTS_STATS (make STATS=1); otherwise every hook below is empty and the
+ * hot paths are unchanged.  The run report is always available and then
+ * carries "counters": null.
+ */
+#ifndef RTS_STATS_H
+#define RTS_STATS_H
+
+#include "rts_types.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+struct rts_sched_class;
+
+/* One priority comparison */
+static inline void rts_stats_cmp(struct rts_stats *s) {
+#ifdef RTS_STATS
+	if (s)
+		s->prio_cmps++;
+#else
+	(void)s;
+#endif
+}
+
+/* A job entered the ready queue; @cmps is s->prio_cmps before the insert */
+static inline void rts_stats_enqueue(struct rts_stats *s, uint64_t cmps) {
+#ifdef RTS_STATS
+	if (!s)
+		return;
+	s->insert_cmps += s->prio_cmps - cmps;
+	if (++s->rq_len > s->rq_len_max)
+		s->rq_len_max = s->rq_len;
+#else
+	(void)s;
+	(void)cmps;
+#endif
+}
+
+/* A job left the ready queue */
+static inline void rts_stats_dequeue(struct rts_stats *s) {
+#ifdef RTS_STATS
+	if (s)
+		s->rq_len--;
+#else
+	(void)s;
+#endif
+}
+
+/* A job was taken from the job pool */
+static inline void rts_stats_alloc(struct rts_stats *s) {
+#ifdef RTS_STATS
+	s->job_allocs++;
+#else
+	(void)s;
+#endif
+}
+
+/* @len time units were simulated with @idle_cpus CPUs idle */
+static inline void rts_stats_step(struct rts_stats *s, rts_time_t len, int idle_cpus) {
+#ifdef RTS_STATS
+	s->rq_len_sum += (uint64_t)s->rq_len * (uint64_t)len;
+	s->time += (uint64_t)len;
+	s->idle += (uint64_t)len * (uint64_t)idle_cpus;
+#else
+	(void)s;
+	(void)len;
+	(void)idle_cpus;
+#endif
+}
+
+/**
+ * rts_stats_report - write the report of a finished run as one JSON line
+ * @out:    destination
+ * @sim:    simulation after its run
+ * @sched:  policy it ran
+ * @n_cpus: number of CPUs (and of trace writers in @sim->trace)
+ *
+ * With @sim->task_stats set, a "task_stats" array adds each task's
+ * response time, lateness and start delay.  The line is written under the
+ * stream lock, so runs on several threads may share @out.
+ */
+void rts_stats_report(FILE *out, const struct rts_sim *sim,
+                      const struct rts_sched_class *sched, int n_cpus);
+
+#endif /* RTS_STATS_H */
@@ -2,13 +2,42 @@
 /**
  * @file rts_trace.h
  * @brief Trace file output utility.
+ *
+ * Three trace formats are supported:
+ *   - tick:     one "[%03d] T%d:J%d" / "[%03d] IDLE" line per time unit
+ *   - interval: one "start,end,tid,jid" line per run of the same job or
+ *               IDLE; end is exclusive, tid/jid are 1-based, 0,0 is IDLE
+ *   - binary:   RTS_TRACE_MAGIC followed by RTS_TRACE_REC_LEN-byte
+ *               little-endian records: int64 start, int64 end, int32 tid,
+ *               int32 jid
+ * Interval and binary output scale with context switches, not ticks;
+ * rts_trace_to_ticks() converts either back to the tick format.
+ *
+ * Multiprocessor runs trace each CPU as an interval trace and merge them
+ * with rts_trace_merge():
+ *   - tick:     "[%03d] T1:J1 | IDLE | T4:J2", one column per CPU
+ *   - interval: "cpu,start,end,tid,jid" records ordered by start time
  */
 #ifndef RTS_TRACE_H
 #define RTS_TRACE_H
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 
+/* Room for a stem from rts_trace_stem(); longer ones are truncated */
+#define RTS_TRACE_STEM_MAX 256
+
+/**
+ * rts_trace_stem - name of the directory a task file's traces go to
+ * @path:  task file path (e.g., "input/test1.txt"; NULL: "trace")
+ * @out:   output, the file name without directory and extension
+ * @outsz: size of @out
+ *
+ * Task files with the same stem share one trace directory.
+ */
+void rts_trace_stem(const char *path, char *out, size_t outsz);
+
 /**
  * rts_trace_open - build trace file path and open it for writing
  * @outdir:     output directory (e.g., "output")
@@ -24,4 +53,105 @@ FILE *rts_trace_open(const char *outdir,
                      const char *sched_name,
                      char *outpath, size_t outpath_sz);
 
+enum rts_trace_format {
+	RTS_TRACE_TICK = 0,
+	RTS_TRACE_INTERVAL,
+	RTS_TRACE_BINARY,
+};
+
+/* Binary trace file header */
+#define RTS_TRACE_MAGIC     "RTSTRC2"
+#define RTS_TRACE_MAGIC_LEN 8
+#define RTS_TRACE_REC_LEN   24
+
+/**
+ * rts_trace_format_from_name - look up a format ("tick", "interval", "binary")
+ * Returns -1 if the name is unknown.
+ */
+int rts_trace_format_from_name(const char *name);
+
+/**
+ * rts_trace_open_fmt - like rts_trace_open() for a given format
+ *
+ * The file extension is ".txt" for tick, ".itv" for interval and ".bin"
+ * for binary traces.
+ */
+FILE *rts_trace_open_fmt(const char *outdir,
+                         const char *task_path,
+                         const char *sched_name,
+                         enum rts_trace_format fmt,
+                         char *outpath, size_t outpath_sz);
+
+/**
+ * struct rts_trace - trace writer
+ * @fp:      output stream
+ * @fmt:     enum rts_trace_format
+ * @pending: whether @start..@jid hold an interval not yet written
+ * @start:   pending interval start
+ * @end:     pending interval end (exclusive)
+ * @tid:     pending task id (0-based, -1 for IDLE)
+ * @jid:     pending job id
+ * @bytes:   bytes written so far, header included
+ */
+struct rts_trace {
+	FILE *fp;
+	int fmt;
+	int pending;
+	int64_t start;
+	int64_t end;
+	int tid;
+	int jid;
+	uint64_t bytes;
+};
+
+/**
+ * rts_trace_init - bind a writer to an open stream and write the header
+ */
+void rts_trace_init(struct rts_trace *tr, FILE *fp, enum rts_trace_format fmt);
+
+/**
+ * rts_trace_emit - record that job @jid of task @tid (-1: IDLE) ran
+ * during [@start, @end)
+ *
+ * Contiguous records of the same job are merged before they are written.
+ */
+void rts_trace_emit(struct rts_trace *tr, int64_t start, int64_t end, int tid, int jid);
+
+/**
+ * rts_trace_flush - write the pending interval, if any
+ */
+void rts_trace_flush(struct rts_trace *tr);
+
+/**
+ * rts_trace_close - flush and close the underlying stream
+ */
+void rts_trace_close(struct rts_trace *tr);
+
+/**
+ * rts_trace_to_ticks - convert an interval or binary trace to tick format
+ * @in:  interval text or binary trace (detected by RTS_TRACE_MAGIC)
+ * @out: destination for the per-tick text trace
+ *
+ * Returns 0 on success, -1 on a malformed input.
+ */
+int rts_trace_to_ticks(FILE *in, FILE *out);
+
+/**
+ * rts_trace_merge - combine per-CPU interval traces into one trace
+ * @in:      interval trace of each CPU, read from the start (NULL: the
+ *           CPU had nothing to run and is shown IDLE throughout)
+ * @tid_map: per CPU, the task id to write for each 0-based task id in its
+ *           trace (NULL, or a NULL entry: unchanged)
+ * @n:       number of CPUs
+ * @out:     destination
+ * @fmt:     RTS_TRACE_TICK or RTS_TRACE_INTERVAL
+ *
+ * In the tick format, a CPU whose trace ends before the others' (e.g., a
+ * steady-state run) shows "-" past its end.
+ *
+ * Returns 0 on success, -1 on a malformed input.
+ */
+int rts_trace_merge(FILE *const *in, const int *const *tid_map, int n,
+                    FILE *out, enum rts_trace_format fmt);
+
 #endif /* RTS_TRACE_H */
@@ -8,8 +8,17 @@
 
 #include "rts_list.h"
 
+#include <stdint.h>
 #include <stdio.h>
 
+/*
+ * Simulation time.  Task parameters fit in an int, but hyperperiods and
+ * absolute times derived from them routinely do not.
+ */
+typedef int64_t rts_time_t;
+
+#define RTS_TIME_MAX INT64_MAX
+
 /**
  * struct rts_task - static attributes of a periodic task
  * @tid:       	  task id
@@ -18,6 +27,14 @@
  * @rel_deadline: relative deadline
  * @wcet:      	  worst-case execution time
  * @util:      	  utilization (wcet/period)
+ * @release_count: number of jobs released so far
+ * @next_release: time of the next job release (kept by the release calendar)
+ * @preemptions:  times one of its jobs was preempted so far
+ * @migrations:   times one of its jobs resumed on another CPU so far
+ * @pt_rank:      position in the policy's fixed-priority order, 0 first
+ *                (preemption-threshold policies only, set by prepare())
+ * @pt_threshold: once one of its jobs has started, only tasks ranked
+ *                strictly above this position can preempt it (likewise)
  */
 struct rts_task {
 	int tid;
@@ -26,28 +43,131 @@ struct rts_task {
 	int rel_deadline;
 	int wcet;
 	double util;
-	int release_count;
+	int64_t release_count;
+	rts_time_t next_release;
+	int preemptions;
+	int migrations;
+	int pt_rank;
+	int pt_threshold;
 };
 
 /**
  * struct rts_job - dynamic instance of a task
  * @tid:           parent task id
- * @jid:           job index (per-task)
+ * @jid:           job index (per-task); labels logs and traces only, so
+ *                 it keeps the low bits of the task's release_count
  * @release:       release time
  * @abs_deadline:  absolute deadline
  * @remain:    	   remaining execution time
+ * @start:         time the job first ran (-1: not yet)
  * @qnode:         embedded list node for ready queue
+ * @hidx:          slot in the ready-queue heap (heap backend only)
+ * @didx:          slot in the ready queue's deadline index
+ * @cpu:           CPU the job last ran on in a global run (-1: none yet)
  */
 struct rts_job {
 	int tid;
 	int jid;
 	
-	int release_time;
-	int abs_deadline;
+	rts_time_t release_time;
+	rts_time_t abs_deadline;
 	
 	int remain;
+	rts_time_t start;
 
 	struct rts_list_head qnode;
+	int hidx;
+	int didx;
+	int cpu;
+};
+
+struct rts_hooks;
+struct rts_log;
+struct rts_rq_ops;
+struct rts_sched_class;
+struct rts_stats;
+struct rts_task_stats;
+struct rts_trace;
+
+/**
+ * struct rts_rq - ready queue
+ * @ops:   backend operations
+ * @sched: scheduler class defining the order
+ * @tasks: task set (passed to higher_prio)
+ * @clock: current simulation time (passed to higher_prio)
+ * @jobs:  every queued job; kept in priority order by the list backend,
+ *         in arrival order by the others
+ * @heap:  array of job pointers (heap backend only)
+ * @nr:    number of heap entries
+ * @cap:   heap capacity
+ * @cur:   job kept outside the heap while it runs (LST backend only)
+ * @dl:    deadline index: every queued job, min-heap on its latest
+ *         feasible start abs_deadline - remain, whatever the backend
+ * @dl_nr: number of @dl entries
+ * @dl_cap: @dl capacity
+ * @stats: counters to update (NULL: none; see rts_stats.h)
+ */
+struct rts_rq {
+	const struct rts_rq_ops *ops;
+	const struct rts_sched_class *sched;
+	const struct rts_task *tasks;
+	const rts_time_t *clock;
+	struct rts_stats *stats;
+
+	struct rts_list_head jobs;
+
+	struct rts_job **heap;
+	int nr;
+	int cap;
+	struct rts_job *cur;
+
+	struct rts_job **dl;
+	int dl_nr;
+	int dl_cap;
+};
+
+/**
+ * struct rts_job_pool - slab allocator for jobs (see rts_job_pool.h)
+ * @slabs:   singly linked list of slabs owned by the pool
+ * @n_slabs: number of slabs
+ * @free:    free job slots, chained through their qnode
+ */
+struct rts_job_pool {
+	void *slabs;
+	int n_slabs;
+	struct rts_list_head free;
+};
+
+/**
+ * struct rts_calendar - release calendar (see rts_calendar.h)
+ * @heap: task indices, min-heap on next_release
+ * @nr:   number of entries
+ */
+struct rts_calendar {
+	int *heap;
+	int nr;
+};
+
+/**
+ * struct rts_stats - hot-path counters of one run (see rts_stats.h)
+ * @prio_cmps:   priority comparisons, i.e. higher_prio() calls
+ * @insert_cmps: the part of @prio_cmps spent inserting into the ready queue
+ * @rq_len:      jobs currently in the ready queue
+ * @rq_len_max:  longest ready queue seen
+ * @rq_len_sum:  ready queue length summed over simulated time units
+ * @time:        simulated time units covered by @rq_len_sum
+ * @job_allocs:  jobs taken from the job pool
+ * @idle:        time units a CPU had nothing to run
+ */
+struct rts_stats {
+	uint64_t prio_cmps;
+	uint64_t insert_cmps;
+	long rq_len;
+	long rq_len_max;
+	uint64_t rq_len_sum;
+	uint64_t time;
+	uint64_t job_allocs;
+	uint64_t idle;
 };
 
 /**
@@ -55,22 +175,62 @@ struct rts_job {
  * @n_tasks:    total number of tasks
  * @ready:      ready queue
  * @running:    currently running job
+ * @rq_ops:     ready-queue backend (NULL: the policy's preferred one)
+ * @job_pool:   allocator for released jobs
+ * @calendar:   upcoming releases of every task
  * @clock:      current simulation time
  * @miss_counts: number of deadline misses
  * @job_counts:  number of jobs entered
- * @trace_fp:   trace output file pointer
+ * @steady:     stop once the schedule provably repeats (see rts_cycle.h)
+ * @cycle_start: with @steady, first boundary of the repeating schedule
+ * @cycle_len:   with @steady, its length (0: no repetition found)
+ * @last:       unfinished job that ran in the previous step (NULL: none)
+ * @preemptions: jobs switched out before completing
+ * @migrations:  jobs resumed on a different CPU (global runs only)
+ * @switch_cost: time charged to a job dispatched in place of a preempted
+ *               one (context switch and cache reload); 0: free
+ * @switches:    dispatches of a job other than the one that ran before
+ * @overhead:    time charged for switches so far (@switch_cost per
+ *               preemption)
+ * @stats:      hot-path counters, updated only in RTS_STATS builds
+ * @task_stats: per-task timing histograms, one per task (NULL: off)
+ * @trace:      trace writer (NULL: no trace); global runs use one per CPU
+ * @log:        console log sink (NULL: silent)
+ * @report:     stream receiving a JSON run report at the end (NULL: none)
+ * @hooks:      event callbacks (NULL: none)
+ * @name:       task set name used in the report (NULL: none)
  */
 struct rts_sim {
-	int clock;
+	rts_time_t clock;
 	int n_tasks;
-	int total_jobs;
-	int missed_jobs;
+	int64_t total_jobs;
+	int64_t missed_jobs;
 
 	struct rts_task *tasks;
 	struct rts_job *running;
-	struct rts_list_head ready_queue;
+	const struct rts_rq_ops *rq_ops;
+	struct rts_rq ready_queue;
+	struct rts_job_pool job_pool;
+	struct rts_calendar calendar;
+
+	int steady;
+	rts_time_t cycle_start;
+	rts_time_t cycle_len;
+
+	struct rts_job *last;
+	long preemptions;
+	long migrations;
+	int switch_cost;
+	long switches;
+	rts_time_t overhead;
+	struct rts_stats stats;
+	struct rts_task_stats *task_stats;
 
-	FILE *trace_fp;
+	struct rts_trace *trace;
+	struct rts_log *log;
+	FILE *report;
+	const char *name;
+	const struct rts_hooks *hooks;
 };
 
 #endif /* RTS_TYPES_H */
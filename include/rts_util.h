@@ -6,9 +6,26 @@
 #ifndef RTS_UTIL_H
 #define RTS_UTIL_H
 
-int rts_util_gcd(int a, int b);
-int rts_util_lcm(int a, int b);
-int rts_util_hyperperiod(const int *arr, int n);
+#include <stdint.h>
+
+int64_t rts_util_gcd(int64_t a, int64_t b);
+
+/**
+ * rts_util_lcm - least common multiple of two positive values
+ * @a:   first value
+ * @b:   second value
+ * @lcm: output
+ *
+ * Returns 0 on success, -1 if the result does not fit in int64_t.
+ */
+int rts_util_lcm(int64_t a, int64_t b, int64_t *lcm);
+
+/**
+ * rts_util_hyperperiod - LCM of @n periods
+ *
+ * Returns 0 on success, -1 on overflow.
+ */
+int rts_util_hyperperiod(const int *periods, int n, int64_t *hp);
 
 static inline int rts_min_int(int a, int b)
 {
@@ -20,4 +37,14 @@ static inline int rts_max_int(int a, int b)
 	return (a > b) ? a : b;
 }
 
+static inline int64_t rts_min_i64(int64_t a, int64_t b)
+{
+	return (a < b) ? a : b;
+}
+
+static inline int64_t rts_max_i64(int64_t a, int64_t b)
+{
+	return (a > b) ? a : b;
+}
+
 #endif /* RTS_UTIL_H */
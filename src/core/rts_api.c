@@ -0,0 +1,297 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_api.c
+ * @brief Embeddable simulator interface (librts).
+ */
+#include "rts_api.h"
+#include "rts_rq.h"
+#include "rts_sched.h"
+#include "rts_sim.h"
+#include "rts_snapshot.h"
+#include "rts_types.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * struct rts_instance - a stepped simulation
+ * @sim:     simulation context, started
+ * @sched:   policy
+ * @engine:  enum rts_engine
+ * @tasks:   private task set
+ * @started: @sim holds queues to release
+ */
+struct rts_instance {
+	struct rts_sim sim;
+	const struct rts_sched_class *sched;
+	int engine;
+	struct rts_task *tasks;
+	int started;
+};
+
+/**
+ * rts_api_start - rewind the task set and counters and start at time 0
+ */
+static int rts_api_start(struct rts_instance *rt) {
+	struct rts_sim *sim = &rt->sim;
+
+	for (int i = 0; i < sim->n_tasks; i++) {
+		struct rts_task *t = &rt->tasks[i];
+
+		t->release_count = 0;
+		t->next_release = t->phase;
+		t->preemptions = 0;
+		t->migrations = 0;
+	}
+
+	sim->clock = 0;
+	sim->total_jobs = 0;
+	sim->missed_jobs = 0;
+	sim->preemptions = 0;
+	sim->migrations = 0;
+	sim->switches = 0;
+	sim->overhead = 0;
+
+	rt->started = rts_sim_start(sim, rt->sched) == 0;
+	return rt->started ? 0 : -1;
+}
+
+/**
+ * rts_api_alloc - allocate an instance with room for @n_tasks tasks,
+ * not yet started
+ */
+static struct rts_instance *rts_api_alloc(const struct rts_sched_class *sched,
+                                          const struct rts_rq_ops *rq_ops,
+                                          int engine, int n_tasks,
+                                          const struct rts_hooks *hooks) {
+	struct rts_instance *rt = calloc(1, sizeof(*rt));
+	size_t n = (size_t)(n_tasks > 0 ? n_tasks : 1);
+
+	if (!rt || !(rt->tasks = malloc(sizeof(*rt->tasks) * n))) {
+		free(rt);
+		return NULL;
+	}
+
+	rt->sched = sched;
+	rt->engine = engine;
+	rt->sim.tasks = rt->tasks;
+	rt->sim.n_tasks = n_tasks;
+	rt->sim.rq_ops = rq_ops;
+	rt->sim.hooks = hooks;
+	return rt;
+}
+
+/**
+ * rts_api_restore - build a started instance from @snap
+ */
+static struct rts_instance *rts_api_restore(const struct rts_snapshot *snap,
+                                            const struct rts_hooks *hooks) {
+	const struct rts_sched_class *sched = rts_sched_from_name(snap->sched);
+	if (!sched)
+		return NULL;
+
+	const struct rts_rq_ops *rq_ops = NULL;
+	if (snap->rq[0] && !(rq_ops = rts_rq_ops_from_name(snap->rq)))
+		return NULL;
+
+	if (snap->engine != RTS_ENGINE_TICK && snap->engine != RTS_ENGINE_EVENT) {
+		fprintf(stderr, "Error: Unknown engine %d\n", snap->engine);
+		return NULL;
+	}
+
+	struct rts_instance *rt = rts_api_alloc(sched, rq_ops, snap->engine,
+	                                        snap->n_tasks, hooks);
+	if (!rt)
+		return NULL;
+
+	if (rts_snapshot_restore(snap, &rt->sim, sched) != 0) {
+		rts_destroy(rt);
+		return NULL;
+	}
+	rt->started = 1;
+	return rt;
+}
+
+struct rts_instance *rts_create(const struct rts_config *cfg) {
+	const struct rts_sched_class *sched = rts_sched_from_name(cfg->sched);
+	if (!sched)
+		return NULL;
+
+	const struct rts_rq_ops *rq_ops = NULL;
+	if (cfg->rq && !(rq_ops = rts_rq_ops_from_name(cfg->rq)))
+		return NULL;
+
+	if (cfg->engine != RTS_ENGINE_TICK && cfg->engine != RTS_ENGINE_EVENT) {
+		fprintf(stderr, "Error: Unknown engine %d\n", cfg->engine);
+		return NULL;
+	}
+
+	if (cfg->switch_cost < 0) {
+		fprintf(stderr, "Error: negative switch cost %d\n", cfg->switch_cost);
+		return NULL;
+	}
+
+	for (int i = 0; i < cfg->n_tasks; i++) {
+		if (cfg->tasks[i].period <= 0 || cfg->tasks[i].wcet <= 0) {
+			fprintf(stderr, "Error: T%d needs a positive period and wcet\n", i + 1);
+			return NULL;
+		}
+	}
+
+	struct rts_instance *rt = rts_api_alloc(sched, rq_ops, cfg->engine,
+	                                        cfg->n_tasks, cfg->hooks);
+	if (!rt)
+		return NULL;
+
+	for (int i = 0; i < cfg->n_tasks; i++) {
+		struct rts_task *t = &rt->tasks[i];
+
+		*t = cfg->tasks[i];
+		t->tid = i;
+		t->util = (double)t->wcet / t->period;
+	}
+	rt->sim.switch_cost = cfg->switch_cost;
+
+	if (rts_api_start(rt) != 0) {
+		rts_destroy(rt);
+		return NULL;
+	}
+	return rt;
+}
+
+void rts_destroy(struct rts_instance *rt) {
+	if (!rt)
+		return;
+
+	if (rt->started)
+		rts_sim_finish(&rt->sim);
+	free(rt->tasks);
+	free(rt);
+}
+
+int rts_reset(struct rts_instance *rt) {
+	if (rt->started)
+		rts_sim_finish(&rt->sim);
+	rt->started = 0;
+
+	return rts_api_start(rt);
+}
+
+void rts_step_until(struct rts_instance *rt, rts_time_t t) {
+	if (!rt->started)
+		return;
+
+	while (rt->sim.clock < t)
+		rts_sim_step(&rt->sim, rt->sched, rt->engine, t);
+}
+
+int rts_run(struct rts_instance *rt) {
+	rts_time_t lcm, max_phase;
+
+	if (rts_sim_horizon(rt->tasks, rt->sim.n_tasks, &lcm, &max_phase, 0) != 0) {
+		fprintf(stderr, "Error: hyperperiod exceeds the 64-bit time range\n");
+		return -1;
+	}
+
+	rts_step_until(rt, lcm + max_phase);
+	return 0;
+}
+
+rts_time_t rts_now(const struct rts_instance *rt) {
+	return rt->sim.clock;
+}
+
+void rts_get_results(const struct rts_instance *rt, struct rts_results *out) {
+	out->clock = rt->sim.clock;
+	out->total_jobs = rt->sim.total_jobs;
+	out->missed_jobs = rt->sim.missed_jobs;
+	out->preemptions = rt->sim.preemptions;
+	out->switches = rt->sim.switches;
+	out->overhead = rt->sim.overhead;
+}
+
+const struct rts_task *rts_get_tasks(const struct rts_instance *rt, int *n_tasks) {
+	*n_tasks = rt->sim.n_tasks;
+	return rt->tasks;
+}
+
+int rts_save(const struct rts_instance *rt, FILE *fp) {
+	struct rts_snapshot snap;
+
+	if (!rt->started || rts_snapshot_take(&snap, &rt->sim, rt->sched, rt->engine) != 0)
+		return -1;
+
+	int ret = rts_snapshot_write(fp, &snap);
+	rts_snapshot_free(&snap);
+	return ret;
+}
+
+struct rts_instance *rts_load(FILE *fp, const struct rts_hooks *hooks) {
+	struct rts_snapshot snap;
+
+	if (rts_snapshot_read(fp, &snap) != 0)
+		return NULL;
+
+	struct rts_instance *rt = rts_api_restore(&snap, hooks);
+	rts_snapshot_free(&snap);
+	return rt;
+}
+
+struct rts_instance *rts_fork(const struct rts_instance *rt,
+                              const struct rts_hooks *hooks) {
+	struct rts_snapshot snap;
+
+	if (!rt->started || rts_snapshot_take(&snap, &rt->sim, rt->sched, rt->engine) != 0)
+		return NULL;
+
+	struct rts_instance *child = rts_api_restore(&snap, hooks);
+	rts_snapshot_free(&snap);
+	return child;
+}
+
+int rts_set_task(struct rts_instance *rt, int tid, int period,
+                 int rel_deadline, int wcet) {
+	struct rts_sim *sim = &rt->sim;
+	struct rts_list_head *p, *n, queued;
+
+	if (!rt->started || tid < 0 || tid >= sim->n_tasks || period <= 0 || wcet <= 0) {
+		fprintf(stderr, "Error: invalid parameters for T%d\n", tid + 1);
+		return -1;
+	}
+
+	struct rts_task *t = &rt->tasks[tid];
+	int requeue = t->period != period || rt->sched->prepare;
+
+	t->period = period;
+	t->rel_deadline = rel_deadline;
+	t->wcet = wcet;
+	t->util = (double)wcet / period;
+
+	if (!requeue)
+		return 0;
+
+	/*
+	 * Priorities may depend on the period, or on per-task state derived
+	 * from the whole task set, so requeue every job.  Taking them in list
+	 * order keeps equal-priority jobs as they were; the counters describe
+	 * the simulation, not this bookkeeping.
+	 */
+	if (rt->sched->prepare && rt->sched->prepare(rt->tasks, sim->n_tasks) != 0)
+		return -1;
+
+	struct rts_stats stats = sim->stats;
+
+	rts_list_init(&queued);
+	rts_list_for_each_safe(p, n, &sim->ready_queue.jobs) {
+		rts_rq_erase(&sim->ready_queue, rts_list_entry(p, struct rts_job, qnode));
+		rts_list_add_tail(p, &queued);
+	}
+	rts_list_for_each_safe(p, n, &queued) {
+		rts_list_del(p);
+		rts_rq_insert(&sim->ready_queue, rts_list_entry(p, struct rts_job, qnode));
+	}
+
+	sim->stats = stats;
+	return 0;
+}
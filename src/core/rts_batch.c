@@ -0,0 +1,443 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_batch.c
+ * @brief Parallel batch runner for many task files x schedulers.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "rts_batch.h"
+#include "rts_hist.h"
+#include "rts_parser.h"
+#include "rts_sched.h"
+#include "rts_sim.h"
+#include "rts_trace.h"
+#include "rts_types.h"
+
+#include <glob.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * struct batch_set - a task file parsed once and shared by all its runs
+ * @path:      task file path
+ * @tasks:     parsed task set (read-only once workers start)
+ * @n_tasks:   number of tasks
+ * @lcm:       hyperperiod
+ * @max_phase: max phase offset
+ */
+struct batch_set {
+	const char *path;
+	struct rts_task *tasks;
+	int n_tasks;
+	rts_time_t lcm;
+	rts_time_t max_phase;
+};
+
+/**
+ * struct batch_item - one (file, policy) simulation and its result
+ */
+struct batch_item {
+	struct batch_set *set;
+	const struct rts_sched_class *sched;
+	int64_t total_jobs;
+	int64_t missed_jobs;
+	double ms;
+};
+
+/**
+ * struct batch_deque - per-worker work-stealing deque
+ * @lock:  protects @head and @tail
+ * @items: item indices
+ * @head:  steal end (oldest)
+ * @tail:  owner end (newest)
+ *
+ * No work is added once the pool starts, so a worker that finds every
+ * deque empty can exit.
+ */
+struct batch_deque {
+	pthread_mutex_t lock;
+	int *items;
+	int head;
+	int tail;
+};
+
+struct batch_pool {
+	const struct rts_batch_opts *opts;
+	struct batch_item *items;
+	struct batch_deque *dq;
+	int n_workers;
+};
+
+struct batch_worker {
+	struct batch_pool *pool;
+	int id;
+};
+
+static int batch_push_path(char ***paths, int *n_paths, const char *path) {
+	char **tmp = realloc(*paths, sizeof(**paths) * (*n_paths + 1));
+	if (!tmp)
+		return -1;
+	*paths = tmp;
+
+	tmp[*n_paths] = strdup(path);
+	if (!tmp[*n_paths])
+		return -1;
+
+	(*n_paths)++;
+	return 0;
+}
+
+int rts_batch_add_paths(char ***paths, int *n_paths, const char *arg) {
+	glob_t g;
+
+	/* GLOB_NOCHECK keeps unmatched names so the loader reports them */
+	if (glob(arg, GLOB_NOCHECK, NULL, &g) != 0) {
+		fprintf(stderr, "[batch] cannot expand '%s'\n", arg);
+		return -1;
+	}
+
+	int ret = 0;
+	for (size_t i = 0; i < g.gl_pathc && ret == 0; i++)
+		ret = batch_push_path(paths, n_paths, g.gl_pathv[i]);
+
+	globfree(&g);
+	return ret;
+}
+
+int rts_batch_add_manifest(char ***paths, int *n_paths, const char *manifest) {
+	FILE *fp = fopen(manifest, "r");
+
+	if (!fp) {
+		perror("open manifest");
+		return -1;
+	}
+
+	char line[1024];
+	int ret = 0;
+
+	while (ret == 0 && fgets(line, sizeof(line), fp)) {
+		char *s = line;
+		while (*s == ' ' || *s == '\t')
+			s++;
+
+		size_t len = strcspn(s, "#\r\n");
+		while (len > 0 && (s[len - 1] == ' ' || s[len - 1] == '\t'))
+			len--;
+		s[len] = '\0';
+
+		if (*s)
+			ret = rts_batch_add_paths(paths, n_paths, s);
+	}
+
+	fclose(fp);
+	return ret;
+}
+
+void rts_batch_free_paths(char **paths, int n_paths) {
+	for (int i = 0; i < n_paths; i++)
+		free(paths[i]);
+	free(paths);
+}
+
+static double batch_now_ms(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void batch_run_item(const struct rts_batch_opts *opts,
+                           struct batch_item *it) {
+	const struct batch_set *set = it->set;
+
+	/* Runs mutate per-task release state, so each gets a private copy */
+	struct rts_task *tasks = malloc(sizeof(*tasks) * (set->n_tasks > 0 ? set->n_tasks : 1));
+	if (!tasks) {
+		fprintf(stderr, "[batch] out of memory for %s/%s\n", set->path, it->sched->name);
+		exit(EXIT_FAILURE);
+	}
+	memcpy(tasks, set->tasks, sizeof(*tasks) * set->n_tasks);
+
+	struct rts_trace trace;
+	FILE *trace_fp = NULL;
+	if (opts->outdir)
+		trace_fp = rts_trace_open_fmt(opts->outdir, set->path, it->sched->name,
+		                              opts->trace_fmt, NULL, 0);
+	rts_trace_init(&trace, trace_fp, opts->trace_fmt);
+
+	struct rts_sim sim = {
+	    .tasks = tasks,
+	    .n_tasks = set->n_tasks,
+	    .trace = trace_fp ? &trace : NULL,
+	    .rq_ops = opts->rq_ops,
+	    .steady = opts->steady,
+	    .log = NULL,
+	    .report = opts->report,
+	    .name = set->path,
+	    .switch_cost = opts->switch_cost,
+	};
+
+	if (opts->task_stats) {
+		sim.task_stats = rts_task_stats_alloc(tasks, set->n_tasks);
+		if (!sim.task_stats) {
+			fprintf(stderr, "[batch] out of memory for %s/%s\n", set->path, it->sched->name);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	double t0 = batch_now_ms();
+	if (opts->engine == RTS_ENGINE_EVENT)
+		rts_sim_run_event(&sim, it->sched, set->lcm, set->max_phase);
+	else
+		rts_sim_run(&sim, it->sched, set->lcm, set->max_phase);
+	it->ms = batch_now_ms() - t0;
+
+	it->total_jobs = sim.total_jobs;
+	it->missed_jobs = sim.missed_jobs;
+
+	rts_trace_close(&trace);
+	free(sim.task_stats);
+	free(tasks);
+}
+
+/**
+ * batch_next - take work: own deque newest-first, else steal oldest-first
+ */
+static int batch_next(struct batch_pool *pool, int self) {
+	struct batch_deque *dq = &pool->dq[self];
+	int idx = -1;
+
+	pthread_mutex_lock(&dq->lock);
+	if (dq->tail > dq->head)
+		idx = dq->items[--dq->tail];
+	pthread_mutex_unlock(&dq->lock);
+
+	for (int k = 1; idx < 0 && k < pool->n_workers; k++) {
+		struct batch_deque *victim = &pool->dq[(self + k) % pool->n_workers];
+
+		pthread_mutex_lock(&victim->lock);
+		if (victim->tail > victim->head)
+			idx = victim->items[victim->head++];
+		pthread_mutex_unlock(&victim->lock);
+	}
+
+	return idx;
+}
+
+static void *batch_worker_main(void *arg) {
+	struct batch_worker *w = arg;
+	struct batch_pool *pool = w->pool;
+	int idx;
+
+	while ((idx = batch_next(pool, w->id)) >= 0)
+		batch_run_item(pool->opts, &pool->items[idx]);
+
+	return NULL;
+}
+
+static int batch_default_workers(void) {
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (int)n : 1;
+}
+
+/**
+ * batch_execute - run @n_items items on a worker pool
+ *
+ * Items are dealt round-robin; idle workers steal from busy ones.  Falls
+ * back to running on the calling thread if threads cannot be created.
+ */
+static void batch_execute(const struct rts_batch_opts *opts,
+                          struct batch_item *items, int n_items) {
+	int n_workers = opts->n_workers > 0 ? opts->n_workers : batch_default_workers();
+	if (n_workers > n_items)
+		n_workers = n_items;
+	if (n_workers < 1)
+		return;
+
+	struct batch_pool pool = {
+	    .opts = opts,
+	    .items = items,
+	    .n_workers = n_workers,
+	};
+	pool.dq = calloc((size_t)n_workers, sizeof(*pool.dq));
+	int *slots = malloc(sizeof(*slots) * n_items);
+	pthread_t *tids = malloc(sizeof(*tids) * n_workers);
+	struct batch_worker *workers = malloc(sizeof(*workers) * n_workers);
+
+	if (!pool.dq || !slots || !tids || !workers) {
+		for (int i = 0; i < n_items; i++)
+			batch_run_item(opts, &items[i]);
+		goto out;
+	}
+
+	/* Worker w owns items w, w + n, w + 2n, ... laid out contiguously */
+	int off = 0;
+	for (int w = 0; w < n_workers; w++) {
+		struct batch_deque *dq = &pool.dq[w];
+
+		pthread_mutex_init(&dq->lock, NULL);
+		dq->items = &slots[off];
+		dq->head = 0;
+		dq->tail = 0;
+		for (int i = w; i < n_items; i += n_workers)
+			dq->items[dq->tail++] = i;
+		off += dq->tail;
+	}
+
+	int started = 0;
+	for (int w = 0; w < n_workers; w++) {
+		workers[w].pool = &pool;
+		workers[w].id = w;
+		if (w > 0 && pthread_create(&tids[w], NULL, batch_worker_main, &workers[w]) != 0)
+			break;
+		started++;
+	}
+
+	/* The calling thread is worker 0; it also drains anything unstarted */
+	batch_worker_main(&workers[0]);
+
+	for (int w = 1; w < started; w++)
+		pthread_join(tids[w], NULL);
+
+	for (int w = 0; w < n_workers; w++)
+		pthread_mutex_destroy(&pool.dq[w].lock);
+
+out:
+	free(workers);
+	free(tids);
+	free(slots);
+	free(pool.dq);
+}
+
+static void batch_print(FILE *out, const struct batch_item *items, int n_items) {
+	int64_t total_jobs = 0, total_misses = 0;
+	double total_ms = 0.0;
+
+	fprintf(out, "%-32s %-6s %6s %12s %10s %8s %10s\n",
+	        "FILE", "POLICY", "TASKS", "HYPERPERIOD", "JOBS", "MISSES", "TIME(ms)");
+
+	for (int i = 0; i < n_items; i++) {
+		const struct batch_item *it = &items[i];
+
+		fprintf(out, "%-32s %-6s %6d %12" PRId64 " %10" PRId64 " %8" PRId64 " %10.3f\n",
+		        it->set->path, it->sched->name, it->set->n_tasks,
+		        it->set->lcm, it->total_jobs, it->missed_jobs, it->ms);
+
+		total_jobs += it->total_jobs;
+		total_misses += it->missed_jobs;
+		total_ms += it->ms;
+	}
+
+	fprintf(out, "%-32s %-6s %6s %12s %10" PRId64 " %8" PRId64 " %10.3f\n",
+	        "TOTAL", "", "", "", total_jobs, total_misses, total_ms);
+}
+
+struct batch_stem {
+	char name[RTS_TRACE_STEM_MAX];
+	const char *path;
+};
+
+static int batch_stem_cmp(const void *pa, const void *pb) {
+	const struct batch_stem *a = pa;
+	const struct batch_stem *b = pb;
+
+	return strcmp(a->name, b->name);
+}
+
+/**
+ * batch_unique_stems - check that no two task files share a trace directory
+ *
+ * Traces go to <outdir>/<stem>/<POLICY>.<ext>, so files with the same
+ * stem (a/t.txt, b/t.txt) would have workers writing one file at once.
+ *
+ * Returns 1 if every stem is distinct, 0 if not (reported on stderr).
+ */
+static int batch_unique_stems(const struct batch_set *sets, int n_sets,
+                              const char *outdir) {
+	struct batch_stem *st = malloc(sizeof(*st) * (size_t)(n_sets > 0 ? n_sets : 1));
+	int ok = 1;
+
+	if (!st) {
+		fprintf(stderr, "[batch] out of memory checking trace paths\n");
+		return 0;
+	}
+
+	for (int s = 0; s < n_sets; s++) {
+		rts_trace_stem(sets[s].path, st[s].name, sizeof(st[s].name));
+		st[s].path = sets[s].path;
+	}
+	qsort(st, (size_t)n_sets, sizeof(*st), batch_stem_cmp);
+
+	for (int s = 1; s < n_sets; s++) {
+		if (strcmp(st[s - 1].name, st[s].name) == 0) {
+			fprintf(stderr, "Error: %s and %s would both write traces to %s/%s; "
+			        "rename one or pass --no-trace\n",
+			        st[s - 1].path, st[s].path, outdir, st[s].name);
+			ok = 0;
+		}
+	}
+
+	free(st);
+	return ok;
+}
+
+int rts_batch_run(const struct rts_batch_opts *opts, FILE *out) {
+	struct batch_set *sets = calloc((size_t)(opts->n_paths > 0 ? opts->n_paths : 1), sizeof(*sets));
+	if (!sets)
+		return 1;
+
+	int status = 0;
+	int n_sets = 0;
+
+	for (int i = 0; i < opts->n_paths; i++) {
+		struct batch_set *set = &sets[n_sets];
+
+		set->path = opts->paths[i];
+		set->tasks = rts_parser_load_tasks(set->path, &set->n_tasks);
+		if (!set->tasks) {
+			fprintf(stderr, "Failed to load %s\n", set->path);
+			status = 1;
+			continue;
+		}
+
+		if (rts_sim_horizon(set->tasks, set->n_tasks, &set->lcm, &set->max_phase,
+		                    opts->steady) != 0) {
+			fprintf(stderr, "Error: hyperperiod of %s exceeds the 64-bit time range\n", set->path);
+			free(set->tasks);
+			status = 1;
+			continue;
+		}
+		n_sets++;
+	}
+
+	int n_items = n_sets * opts->n_scheds;
+	struct batch_item *items = NULL;
+
+	if (opts->outdir && !batch_unique_stems(sets, n_sets, opts->outdir)) {
+		status = 1;
+	} else if ((items = calloc((size_t)(n_items > 0 ? n_items : 1), sizeof(*items)))) {
+		for (int s = 0; s < n_sets; s++) {
+			for (int p = 0; p < opts->n_scheds; p++) {
+				struct batch_item *it = &items[s * opts->n_scheds + p];
+				it->set = &sets[s];
+				it->sched = opts->scheds[p];
+			}
+		}
+
+		batch_execute(opts, items, n_items);
+		batch_print(out, items, n_items);
+		free(items);
+	} else {
+		status = 1;
+	}
+
+	for (int s = 0; s < n_sets; s++)
+		free(sets[s].tasks);
+	free(sets);
+
+	return status;
+}
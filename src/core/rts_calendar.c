@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_calendar.c
+ * @brief Release calendar implementation (binary min-heap of task indices).
+ */
+#include "rts_calendar.h"
+#include "rts_types.h"
+
+#include <stdlib.h>
+
+static int cal_before(const struct rts_task *tasks, int a, int b) {
+	if (tasks[a].next_release == tasks[b].next_release)
+		return tasks[a].tid < tasks[b].tid;
+
+	return tasks[a].next_release < tasks[b].next_release;
+}
+
+static void cal_sift_down(struct rts_calendar *cal,
+                          const struct rts_task *tasks, int i) {
+	int idx = cal->heap[i];
+
+	for (;;) {
+		int child = 2 * i + 1;
+		if (child >= cal->nr)
+			break;
+		if (child + 1 < cal->nr &&
+		    cal_before(tasks, cal->heap[child + 1], cal->heap[child]))
+			child++;
+		if (!cal_before(tasks, cal->heap[child], idx))
+			break;
+		cal->heap[i] = cal->heap[child];
+		i = child;
+	}
+	cal->heap[i] = idx;
+}
+
+int rts_calendar_init(struct rts_calendar *cal, struct rts_task *tasks,
+                      int n, rts_time_t now) {
+	for (int i = 0; i < n; i++) {
+		struct rts_task *t = &tasks[i];
+
+		/* first release at or after now: phase + k * period, k >= 0 */
+		if (now <= t->phase) {
+			t->next_release = t->phase;
+		} else {
+			rts_time_t k = (now - t->phase + t->period - 1) / t->period;
+			t->next_release = t->phase + k * t->period;
+		}
+	}
+
+	return rts_calendar_build(cal, tasks, n);
+}
+
+int rts_calendar_build(struct rts_calendar *cal, struct rts_task *tasks, int n) {
+	cal->heap = malloc(sizeof(*cal->heap) * (n > 0 ? n : 1));
+	cal->nr = 0;
+	if (!cal->heap)
+		return -1;
+
+	for (int i = 0; i < n; i++)
+		cal->heap[cal->nr++] = i;
+
+	for (int i = cal->nr / 2 - 1; i >= 0; i--)
+		cal_sift_down(cal, tasks, i);
+
+	return 0;
+}
+
+void rts_calendar_destroy(struct rts_calendar *cal) {
+	free(cal->heap);
+	cal->heap = NULL;
+	cal->nr = 0;
+}
+
+rts_time_t rts_calendar_next(const struct rts_calendar *cal,
+                             const struct rts_task *tasks) {
+	return cal->nr ? tasks[cal->heap[0]].next_release : RTS_TIME_MAX;
+}
+
+int rts_calendar_due(const struct rts_calendar *cal,
+                     const struct rts_task *tasks, rts_time_t now) {
+	if (!cal->nr || tasks[cal->heap[0]].next_release != now)
+		return -1;
+
+	return cal->heap[0];
+}
+
+void rts_calendar_advance(struct rts_calendar *cal, struct rts_task *tasks) {
+	struct rts_task *t = &tasks[cal->heap[0]];
+
+	/* Saturate instead of wrapping past the end of the time axis */
+	if (t->next_release > RTS_TIME_MAX - t->period)
+		t->next_release = RTS_TIME_MAX;
+	else
+		t->next_release += t->period;
+
+	cal_sift_down(cal, tasks, 0);
+}
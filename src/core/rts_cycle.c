@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_cycle.c
+ * @brief Steady-state detection at hyperperiod boundaries.
+ */
+#include "rts_cycle.h"
+#include "rts_sched.h"
+#include "rts_types.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define RTS_CYCLE_JOB_WORDS 4	/* tid, deadline offset, remaining work, dispatch state */
+
+/**
+ * struct rts_cycle_snap - one recorded state
+ * @at:    boundary time
+ * @hash:  hash of @words
+ * @words: per-task release offsets, then sorted per-job tuples
+ * @len:   number of words
+ */
+struct rts_cycle_snap {
+	rts_time_t at;
+	uint64_t hash;
+	int64_t *words;
+	size_t len;
+};
+
+void rts_cycle_init(struct rts_cycle *cyc, rts_time_t period) {
+	cyc->period = period;
+	cyc->snaps = NULL;
+	cyc->nr = 0;
+	cyc->cap = 0;
+}
+
+void rts_cycle_destroy(struct rts_cycle *cyc) {
+	for (int i = 0; i < cyc->nr; i++)
+		free(cyc->snaps[i].words);
+	free(cyc->snaps);
+
+	cyc->snaps = NULL;
+	cyc->nr = 0;
+	cyc->cap = 0;
+}
+
+static int rts_cycle_job_cmp(const void *pa, const void *pb) {
+	const int64_t *a = pa, *b = pb;
+
+	for (int i = 0; i < RTS_CYCLE_JOB_WORDS; i++) {
+		if (a[i] != b[i])
+			return a[i] < b[i] ? -1 : 1;
+	}
+	return 0;
+}
+
+/* FNV-1a over the bytes of each word */
+static uint64_t rts_cycle_hash(const int64_t *words, size_t len) {
+	uint64_t h = 1469598103934665603ULL;
+
+	for (size_t i = 0; i < len; i++) {
+		uint64_t w = (uint64_t)words[i];
+
+		for (int b = 0; b < 8; b++) {
+			h ^= (w >> (8 * b)) & 0xff;
+			h *= 1099511628211ULL;
+		}
+	}
+	return h;
+}
+
+/**
+ * rts_cycle_snapshot - encode the state of @sim relative to its clock
+ *
+ * Jobs are sorted so that backends keeping different list orders produce
+ * the same encoding.
+ */
+static int64_t *rts_cycle_snapshot(const struct rts_sim *sim, size_t *len) {
+	size_t n_jobs = 0;
+	struct rts_list_head *p;
+
+	rts_list_for_each(p, &sim->ready_queue.jobs)
+		n_jobs++;
+
+	size_t n = (size_t)sim->n_tasks + n_jobs * RTS_CYCLE_JOB_WORDS;
+	int64_t *words = malloc(sizeof(*words) * (n > 0 ? n : 1));
+	if (!words)
+		return NULL;
+
+	for (int i = 0; i < sim->n_tasks; i++)
+		words[i] = sim->tasks[i].next_release - sim->clock;
+
+	int64_t *job = &words[sim->n_tasks];
+	rts_list_for_each(p, &sim->ready_queue.jobs) {
+		const struct rts_job *j = rts_list_entry(p, struct rts_job, qnode);
+
+		job[0] = j->tid;
+		job[1] = j->abs_deadline - sim->clock;
+		job[2] = j->remain;
+		/*
+		 * Having started ranks a job higher under limited preemption;
+		 * having run last exempts it from the next switch charge.
+		 */
+		job[3] = rts_job_started(j) | (sim->switch_cost && j == sim->last) << 1;
+		job += RTS_CYCLE_JOB_WORDS;
+	}
+
+	qsort(&words[sim->n_tasks], n_jobs, sizeof(*words) * RTS_CYCLE_JOB_WORDS,
+	      rts_cycle_job_cmp);
+
+	*len = n;
+	return words;
+}
+
+rts_time_t rts_cycle_check(struct rts_cycle *cyc, const struct rts_sim *sim) {
+	size_t len;
+	int64_t *words = rts_cycle_snapshot(sim, &len);
+	if (!words)
+		return -1;
+
+	uint64_t hash = rts_cycle_hash(words, len);
+
+	for (int i = 0; i < cyc->nr; i++) {
+		const struct rts_cycle_snap *s = &cyc->snaps[i];
+
+		if (s->hash == hash && s->len == len &&
+		    memcmp(s->words, words, sizeof(*words) * len) == 0) {
+			free(words);
+			return s->at;
+		}
+	}
+
+	if (cyc->nr == cyc->cap) {
+		int cap = cyc->cap ? cyc->cap * 2 : 4;
+		struct rts_cycle_snap *tmp = realloc(cyc->snaps, sizeof(*tmp) * cap);
+
+		if (!tmp) {
+			free(words);
+			return -1;
+		}
+		cyc->snaps = tmp;
+		cyc->cap = cap;
+	}
+
+	cyc->snaps[cyc->nr++] = (struct rts_cycle_snap){
+	    .at = sim->clock,
+	    .hash = hash,
+	    .words = words,
+	    .len = len,
+	};
+
+	return -1;
+}
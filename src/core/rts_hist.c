@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_hist.c
+ * @brief Fixed-size log-bucketed histograms.
+ */
+#include "rts_hist.h"
+#include "rts_types.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int rts_hist_msb(uint64_t v) {
+	int b = 0;
+
+	while (v >>= 1)
+		b++;
+	return b;
+}
+
+/* Bucket of magnitude @v */
+static int rts_hist_bucket(uint64_t v) {
+	if (v < RTS_HIST_SUB)
+		return (int)v;
+
+	int msb = rts_hist_msb(v);
+	if (msb >= RTS_HIST_RANGE_BITS)
+		return RTS_HIST_BUCKETS - 1;
+
+	int shift = msb - RTS_HIST_SUB_BITS;
+	return RTS_HIST_SUB + shift * RTS_HIST_SUB + (int)(v >> shift) - RTS_HIST_SUB;
+}
+
+/* Largest magnitude that falls into bucket @i of @n */
+static uint64_t rts_hist_bucket_high(int i, int n) {
+	if (i == n - 1)
+		return UINT64_MAX;
+	if (i < RTS_HIST_SUB)
+		return (uint64_t)i;
+
+	int shift = (i - RTS_HIST_SUB) / RTS_HIST_SUB;
+	uint64_t sub = (uint64_t)((i - RTS_HIST_SUB) % RTS_HIST_SUB);
+
+	return ((RTS_HIST_SUB + sub + 1) << shift) - 1;
+}
+
+/* Buckets resolving magnitudes up to @limit, plus one for larger ones */
+static int rts_hist_buckets(uint64_t limit) {
+	int n = rts_hist_bucket(limit) + 2;
+
+	return n < RTS_HIST_BUCKETS ? n : RTS_HIST_BUCKETS;
+}
+
+/* Count magnitude @v in @b, a side of @n buckets */
+static void rts_hist_count(uint64_t *b, int n, uint64_t v) {
+	if (!n)
+		return;
+
+	int i = rts_hist_bucket(v);
+	b[i < n ? i : n - 1]++;
+}
+
+void rts_hist_record(struct rts_hist *h, int64_t v) {
+	if (!h->count || v < h->min)
+		h->min = v;
+	if (!h->count || v > h->max)
+		h->max = v;
+	h->count++;
+	h->sum += (double)v;
+
+	if (v >= 0)
+		rts_hist_count(h->pos, h->n_pos, (uint64_t)v);
+	else
+		rts_hist_count(h->neg, h->n_neg, -(uint64_t)v);
+}
+
+double rts_hist_mean(const struct rts_hist *h) {
+	return h->count ? h->sum / (double)h->count : 0.0;
+}
+
+int64_t rts_hist_percentile(const struct rts_hist *h, double p) {
+	if (!h->count)
+		return 0;
+
+	/* Rank of the value sought, 1-based */
+	uint64_t rank = (uint64_t)(p / 100.0 * (double)h->count + 0.5);
+	if (rank < 1)
+		rank = 1;
+	if (rank > h->count)
+		rank = h->count;
+
+	uint64_t seen = 0;
+	int64_t v = h->max;
+
+	/* Negative buckets from the largest magnitude down, then the others */
+	for (int i = h->n_neg - 1; i >= 0; i--) {
+		seen += h->neg[i];
+		if (seen >= rank) {
+			/* Upper bound of a negative bucket is its smallest magnitude */
+			v = i ? -(int64_t)rts_hist_bucket_high(i - 1, h->n_neg) - 1 : 0;
+			goto out;
+		}
+	}
+	for (int i = 0; i < h->n_pos; i++) {
+		seen += h->pos[i];
+		if (seen >= rank) {
+			uint64_t high = rts_hist_bucket_high(i, h->n_pos);
+
+			v = high > (uint64_t)INT64_MAX ? INT64_MAX : (int64_t)high;
+			goto out;
+		}
+	}
+
+out:
+	if (v < h->min)
+		v = h->min;
+	if (v > h->max)
+		v = h->max;
+	return v;
+}
+
+struct rts_task_stats *rts_task_stats_alloc(const struct rts_task *tasks, int n_tasks) {
+	size_t n = (size_t)(n_tasks > 0 ? n_tasks : 1);
+	size_t words = 0;
+
+	/* Response and start take [0, D], lateness [-D, 0] */
+	for (int i = 0; i < n_tasks; i++) {
+		int nb = rts_hist_buckets((uint64_t)tasks[i].rel_deadline);
+		words += 3 * (size_t)nb + (size_t)rts_hist_buckets(0);
+	}
+
+	struct rts_task_stats *ts = calloc(1, n * sizeof(*ts) + words * sizeof(uint64_t));
+	if (!ts)
+		return NULL;
+
+	uint64_t *b = (uint64_t *)(ts + n);
+	for (int i = 0; i < n_tasks; i++) {
+		int nb = rts_hist_buckets((uint64_t)tasks[i].rel_deadline);
+
+		ts[i].response.n_pos = nb;
+		ts[i].response.pos = b;
+		b += nb;
+		ts[i].start.n_pos = nb;
+		ts[i].start.pos = b;
+		b += nb;
+		ts[i].lateness.n_neg = nb;
+		ts[i].lateness.neg = b;
+		b += nb;
+		ts[i].lateness.n_pos = rts_hist_buckets(0);
+		ts[i].lateness.pos = b;
+		b += ts[i].lateness.n_pos;
+	}
+
+	return ts;
+}
+
+void rts_task_stats_record(struct rts_task_stats *ts, const struct rts_job *job,
+                           rts_time_t done) {
+	rts_hist_record(&ts->response, done - job->release_time);
+	rts_hist_record(&ts->lateness, done - job->abs_deadline);
+	rts_hist_record(&ts->start, job->start - job->release_time);
+}
+
+static void rts_hist_print(const struct rts_hist *h, FILE *out) {
+	fprintf(out, "%" PRId64 "/%.2f/%" PRId64 "/%" PRId64,
+	        h->count ? h->min : 0, rts_hist_mean(h),
+	        rts_hist_percentile(h, 99.0), h->count ? h->max : 0);
+}
+
+void rts_task_stats_print(const struct rts_task_stats *ts, int n_tasks, FILE *out) {
+	fprintf(out, "Per-task timing of completed jobs (min/mean/p99/max):\n");
+
+	for (int i = 0; i < n_tasks; i++) {
+		const struct rts_task_stats *s = &ts[i];
+
+		fprintf(out, "  T%d: done=%" PRIu64 " response=", i + 1, s->response.count);
+		rts_hist_print(&s->response, out);
+		fprintf(out, " lateness=");
+		rts_hist_print(&s->lateness, out);
+		fprintf(out, " start=");
+		rts_hist_print(&s->start, out);
+		fprintf(out, " jitter: start=%" PRId64 " response=%" PRId64 "\n",
+		        s->start.count ? s->start.max - s->start.min : 0,
+		        s->response.count ? s->response.max - s->response.min : 0);
+	}
+}
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_job_pool.c
+ * @brief Slab allocator for rts_job.
+ *
+ * Each slab starts with a one-cache-line header linking it to the next
+ * slab, followed by RTS_JOB_POOL_SLAB_JOBS job slots.  Free slots are
+ * chained through their embedded qnode.
+ */
+#include "rts_job_pool.h"
+#include "rts_types.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <malloc.h>   	/* _aligned_malloc */
+#define RTS_ALIGNED_ALLOC(a, sz) _aligned_malloc(sz, a)
+#define RTS_ALIGNED_FREE(p) _aligned_free(p)
+#else
+#define RTS_ALIGNED_ALLOC(a, sz) aligned_alloc(a, sz)
+#define RTS_ALIGNED_FREE(p) free(p)
+#endif
+
+/**
+ * struct rts_job_slab - slab header
+ * @next: next slab owned by the same pool
+ */
+struct rts_job_slab {
+	struct rts_job_slab *next;
+};
+
+#define RTS_JOB_SLAB_HDR RTS_JOB_POOL_ALIGN
+
+/* aligned_alloc() wants a multiple of the alignment */
+#define RTS_JOB_SLAB_SIZE \
+	((RTS_JOB_SLAB_HDR + RTS_JOB_POOL_SLAB_JOBS * sizeof(struct rts_job) + \
+	  RTS_JOB_POOL_ALIGN - 1) / RTS_JOB_POOL_ALIGN * RTS_JOB_POOL_ALIGN)
+
+void rts_job_pool_init(struct rts_job_pool *pool) {
+	pool->slabs = NULL;
+	pool->n_slabs = 0;
+	rts_list_init(&pool->free);
+}
+
+static int rts_job_pool_grow(struct rts_job_pool *pool) {
+	struct rts_job_slab *slab = RTS_ALIGNED_ALLOC(RTS_JOB_POOL_ALIGN, RTS_JOB_SLAB_SIZE);
+	if (!slab)
+		return -1;
+
+	slab->next = pool->slabs;
+	pool->slabs = slab;
+	pool->n_slabs++;
+
+	struct rts_job *jobs = (struct rts_job *)((char *)slab + RTS_JOB_SLAB_HDR);
+	for (int i = 0; i < RTS_JOB_POOL_SLAB_JOBS; i++) {
+		rts_list_push_back(&jobs[i].qnode, &pool->free);
+	}
+
+	return 0;
+}
+
+struct rts_job *rts_job_pool_alloc(struct rts_job_pool *pool) {
+	if (rts_list_empty(&pool->free) && rts_job_pool_grow(pool) != 0)
+		return NULL;
+
+	struct rts_list_head *node = rts_list_pop_front(&pool->free);
+	struct rts_job *job = rts_list_entry(node, struct rts_job, qnode);
+
+	memset(job, 0, sizeof(*job));
+	rts_list_init(&job->qnode);
+	return job;
+}
+
+void rts_job_pool_free(struct rts_job_pool *pool, struct rts_job *job) {
+	/* LIFO keeps recently used, cache-hot slots in circulation */
+	rts_list_push_front(&job->qnode, &pool->free);
+}
+
+void rts_job_pool_destroy(struct rts_job_pool *pool) {
+	struct rts_job_slab *slab = pool->slabs;
+
+	while (slab) {
+		struct rts_job_slab *next = slab->next;
+		RTS_ALIGNED_FREE(slab);
+		slab = next;
+	}
+
+	rts_job_pool_init(pool);
+}
@@ -0,0 +1,365 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_partition.c
+ * @brief Partitioned multiprocessor scheduling.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "rts_hist.h"
+#include "rts_partition.h"
+#include "rts_sched.h"
+#include "rts_sim.h"
+#include "rts_trace.h"
+#include "rts_types.h"
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Slack for rounding in summed utilizations */
+#define PART_UTIL_EPS 1e-9
+
+/**
+ * struct part_worker - one core's simulation, run on its own thread
+ */
+struct part_worker {
+	struct rts_partition_core *core;
+	int cpu;
+	const struct rts_sched_class *sched;
+	const struct rts_partition_opts *opts;
+	rts_time_t lcm;
+	rts_time_t max_phase;
+};
+
+int rts_partition_fit_from_name(const char *name) {
+	if (!name)
+		return -1;
+	if (strcmp(name, "ffd") == 0)
+		return RTS_PART_FFD;
+	if (strcmp(name, "wfd") == 0)
+		return RTS_PART_WFD;
+	if (strcmp(name, "bfd") == 0)
+		return RTS_PART_BFD;
+	return -1;
+}
+
+/* Decreasing utilization, then increasing tid */
+static int part_util_cmp(const void *pa, const void *pb) {
+	const struct rts_task *a = *(const struct rts_task *const *)pa;
+	const struct rts_task *b = *(const struct rts_task *const *)pb;
+
+	if (a->util != b->util)
+		return a->util > b->util ? -1 : 1;
+	return a->tid < b->tid ? -1 : (a->tid > b->tid);
+}
+
+static int part_tid_cmp(const void *pa, const void *pb) {
+	const struct rts_task *a = pa, *b = pb;
+
+	return a->tid < b->tid ? -1 : (a->tid > b->tid);
+}
+
+/**
+ * part_admits - whether @core can take @t without failing the policy test
+ *
+ * @t is appended tentatively; the slot is always available since every
+ * core has room for the whole task set.
+ */
+static int part_admits(struct rts_partition_core *core, const struct rts_task *t,
+                       const struct rts_sched_class *sched) {
+	if (core->util + t->util > 1.0 + PART_UTIL_EPS)
+		return 0;
+
+	if (!sched->schedulability_test)
+		return 1;
+
+	core->tasks[core->n_tasks] = *t;
+	return sched->schedulability_test(core->tasks, core->n_tasks + 1, NULL);
+}
+
+static void part_add(struct rts_partition_core *core, const struct rts_task *t) {
+	core->tasks[core->n_tasks++] = *t;
+	core->util += t->util;
+}
+
+int rts_partition_assign(struct rts_partition *part,
+                         const struct rts_task *tasks, int n_tasks,
+                         int n_cores, int fit,
+                         const struct rts_sched_class *sched) {
+	size_t cap = (size_t)(n_tasks > 0 ? n_tasks : 1);
+
+	*part = (struct rts_partition){ .n_cores = n_cores };
+	part->cores = calloc((size_t)n_cores, sizeof(*part->cores));
+	if (!part->cores)
+		return -1;
+
+	for (int c = 0; c < n_cores; c++) {
+		struct rts_partition_core *core = &part->cores[c];
+
+		core->tasks = malloc(sizeof(*core->tasks) * cap);
+		core->gtid = malloc(sizeof(*core->gtid) * cap);
+		if (!core->tasks || !core->gtid)
+			goto fail;
+	}
+
+	const struct rts_task **order = malloc(sizeof(*order) * cap);
+	if (!order)
+		goto fail;
+
+	for (int i = 0; i < n_tasks; i++)
+		order[i] = &tasks[i];
+	qsort(order, (size_t)n_tasks, sizeof(*order), part_util_cmp);
+
+	for (int i = 0; i < n_tasks; i++) {
+		const struct rts_task *t = order[i];
+		int best = -1;
+
+		for (int c = 0; c < n_cores; c++) {
+			const struct rts_partition_core *core = &part->cores[c];
+
+			if (!part_admits(&part->cores[c], t, sched))
+				continue;
+
+			if (best < 0) {
+				best = c;
+				if (fit == RTS_PART_FFD)
+					break;
+			} else if ((fit == RTS_PART_WFD && core->util < part->cores[best].util) ||
+			           (fit == RTS_PART_BFD && core->util > part->cores[best].util)) {
+				best = c;
+			}
+		}
+
+		if (best < 0) {
+			best = 0;
+			for (int c = 1; c < n_cores; c++) {
+				if (part->cores[c].util < part->cores[best].util)
+					best = c;
+			}
+			part->n_forced++;
+		}
+
+		part_add(&part->cores[best], t);
+	}
+	free(order);
+
+	/* Each core is simulated on its own, with tids indexing its tasks */
+	for (int c = 0; c < n_cores; c++) {
+		struct rts_partition_core *core = &part->cores[c];
+
+		qsort(core->tasks, (size_t)core->n_tasks, sizeof(*core->tasks), part_tid_cmp);
+		for (int i = 0; i < core->n_tasks; i++) {
+			core->gtid[i] = core->tasks[i].tid;
+			core->tasks[i].tid = i;
+		}
+	}
+
+	return 0;
+
+fail:
+	rts_partition_destroy(part);
+	return -1;
+}
+
+void rts_partition_print(const struct rts_partition *part, FILE *out) {
+	for (int c = 0; c < part->n_cores; c++) {
+		const struct rts_partition_core *core = &part->cores[c];
+
+		fprintf(out, "  CPU%d (U=%.3f):", c, core->util);
+		for (int i = 0; i < core->n_tasks; i++)
+			fprintf(out, " T%d", core->gtid[i] + 1);
+		fprintf(out, "%s\n", core->n_tasks ? "" : " idle");
+	}
+}
+
+static double part_now_ms(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void part_run_core(struct part_worker *w) {
+	struct rts_partition_core *core = w->core;
+
+	/* Runs advance the release state, so start every run afresh */
+	for (int i = 0; i < core->n_tasks; i++) {
+		core->tasks[i].release_count = 0;
+		core->tasks[i].next_release = core->tasks[i].phase;
+		core->tasks[i].preemptions = 0;
+		core->tasks[i].migrations = 0;
+	}
+
+	if (core->trace)
+		fclose(core->trace);
+	core->trace = NULL;
+
+	struct rts_trace trace;
+	FILE *fp = NULL;
+	if (w->opts->trace) {
+		fp = tmpfile();
+		if (!fp)
+			fprintf(stderr, "[partition] cannot buffer the trace of CPU%d\n", w->cpu);
+	}
+	rts_trace_init(&trace, fp, RTS_TRACE_INTERVAL);
+
+	char name[32];
+	snprintf(name, sizeof(name), "CPU%d", w->cpu);
+
+	struct rts_sim sim = {
+	    .tasks = core->tasks,
+	    .n_tasks = core->n_tasks,
+	    .trace = fp ? &trace : NULL,
+	    .rq_ops = w->opts->rq_ops,
+	    .steady = w->opts->steady,
+	    .log = NULL,
+	    .report = w->opts->report,
+	    .name = name,
+	    .switch_cost = w->opts->switch_cost,
+	};
+
+	/*
+	 * Local tids, so gather into a private array and scatter afterwards;
+	 * the bucket storage stays that of the caller's array
+	 */
+	if (w->opts->task_stats) {
+		sim.task_stats = calloc((size_t)(core->n_tasks > 0 ? core->n_tasks : 1),
+		                        sizeof(*sim.task_stats));
+		if (!sim.task_stats)
+			fprintf(stderr, "[partition] out of memory for task stats of CPU%d\n", w->cpu);
+		for (int i = 0; sim.task_stats && i < core->n_tasks; i++)
+			sim.task_stats[i] = w->opts->task_stats[core->gtid[i]];
+	}
+
+	double t0 = part_now_ms();
+	if (w->opts->engine == RTS_ENGINE_EVENT)
+		rts_sim_run_event(&sim, w->sched, w->lcm, w->max_phase);
+	else
+		rts_sim_run(&sim, w->sched, w->lcm, w->max_phase);
+	core->ms = part_now_ms() - t0;
+
+	core->total_jobs = sim.total_jobs;
+	core->missed_jobs = sim.missed_jobs;
+	core->preemptions = sim.preemptions;
+	core->switches = sim.switches;
+	core->overhead = sim.overhead;
+	core->cycle_start = sim.cycle_start;
+	core->cycle_len = sim.cycle_len;
+
+	for (int i = 0; sim.task_stats && i < core->n_tasks; i++)
+		w->opts->task_stats[core->gtid[i]] = sim.task_stats[i];
+	free(sim.task_stats);
+
+	/* Kept open for rts_partition_merge_trace() */
+	rts_trace_flush(&trace);
+	core->trace = fp;
+}
+
+static void *part_worker_main(void *arg) {
+	part_run_core(arg);
+	return NULL;
+}
+
+void rts_partition_run(struct rts_partition *part,
+                       const struct rts_sched_class *sched,
+                       const struct rts_partition_opts *opts,
+                       rts_time_t lcm, rts_time_t max_phase) {
+	int n = part->n_cores;
+	struct part_worker *workers = calloc((size_t)n, sizeof(*workers));
+	pthread_t *tids = calloc((size_t)n, sizeof(*tids));
+	int *started = calloc((size_t)n, sizeof(*started));
+
+	for (int c = 0; c < n; c++) {
+		struct rts_partition_core *core = &part->cores[c];
+		struct part_worker w = {
+		    .core = core,
+		    .cpu = c,
+		    .sched = sched,
+		    .opts = opts,
+		    .lcm = lcm,
+		    .max_phase = max_phase,
+		};
+
+		core->total_jobs = 0;
+		core->missed_jobs = 0;
+		core->preemptions = 0;
+		core->switches = 0;
+		core->overhead = 0;
+		core->cycle_start = 0;
+		core->cycle_len = 0;
+		core->ms = 0.0;
+		if (core->n_tasks == 0)
+			continue;
+
+		if (!workers || !tids || !started) {
+			part_run_core(&w);
+			continue;
+		}
+
+		workers[c] = w;
+		started[c] = pthread_create(&tids[c], NULL, part_worker_main, &workers[c]) == 0;
+	}
+
+	if (workers && tids && started) {
+		for (int c = 0; c < n; c++) {
+			if (started[c])
+				pthread_join(tids[c], NULL);
+			else if (part->cores[c].n_tasks > 0)
+				part_run_core(&workers[c]);
+		}
+	}
+
+	free(started);
+	free(tids);
+	free(workers);
+}
+
+void rts_partition_collect(const struct rts_partition *part, struct rts_task *tasks) {
+	for (int c = 0; c < part->n_cores; c++) {
+		const struct rts_partition_core *core = &part->cores[c];
+
+		for (int i = 0; i < core->n_tasks; i++) {
+			struct rts_task *t = &tasks[core->gtid[i]];
+
+			t->release_count = core->tasks[i].release_count;
+			t->preemptions = core->tasks[i].preemptions;
+			t->migrations = 0;
+		}
+	}
+}
+
+int rts_partition_merge_trace(const struct rts_partition *part, FILE *out, int fmt) {
+	int n = part->n_cores;
+	FILE **in = malloc(sizeof(*in) * (size_t)n);
+	const int **map = malloc(sizeof(*map) * (size_t)n);
+	int ret = -1;
+
+	if (in && map) {
+		for (int c = 0; c < n; c++) {
+			in[c] = part->cores[c].trace;
+			map[c] = part->cores[c].gtid;
+		}
+		ret = rts_trace_merge(in, map, n, out, fmt);
+	}
+
+	free(map);
+	free(in);
+	return ret;
+}
+
+void rts_partition_destroy(struct rts_partition *part) {
+	for (int c = 0; part->cores && c < part->n_cores; c++) {
+		struct rts_partition_core *core = &part->cores[c];
+
+		if (core->trace)
+			fclose(core->trace);
+		free(core->gtid);
+		free(core->tasks);
+	}
+	free(part->cores);
+
+	part->cores = NULL;
+	part->n_cores = 0;
+}
@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_sens.c
+ * @brief Critical scaling factor search.
+ */
+#include "rts_sched.h"
+#include "rts_sens.h"
+#include "rts_sim.h"
+#include "rts_types.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Slack on the floating-point utilization sum when the hyperperiod is unknown */
+#define SENS_UTIL_EPS 1e-9
+
+int rts_sens_init(struct rts_sens *s, const struct rts_task *tasks, int n_tasks,
+                  int target, const struct rts_rq_ops *rq_ops) {
+	memset(s, 0, sizeof(*s));
+
+	if (target != RTS_SENS_ALL && (target < 0 || target >= n_tasks))
+		return -1;
+
+	s->scaled = malloc(sizeof(*s->scaled) * (size_t)(n_tasks > 0 ? n_tasks : 1));
+	if (!s->scaled)
+		return -1;
+	memcpy(s->scaled, tasks, sizeof(*tasks) * (size_t)n_tasks);
+
+	s->tasks = tasks;
+	s->n_tasks = n_tasks;
+	s->target = target;
+	s->rq_ops = rq_ops;
+	s->sim_ok = rts_sim_horizon(tasks, n_tasks, &s->lcm, &s->max_phase, 0) == 0;
+
+	s->sync = 1;
+	for (int i = 0; i < n_tasks; i++)
+		s->sync &= tasks[i].phase == 0;
+
+	return 0;
+}
+
+void rts_sens_destroy(struct rts_sens *s) {
+	free(s->scaled);
+	s->scaled = NULL;
+}
+
+/**
+ * sens_scale - set the scratch WCETs to ceil(@alpha * C), at least 1
+ *
+ * Returns the resulting total utilization.
+ */
+static double sens_scale(struct rts_sens *s, double alpha) {
+	double util = 0.0;
+
+	for (int i = 0; i < s->n_tasks; i++) {
+		struct rts_task *t = &s->scaled[i];
+		int wcet = s->tasks[i].wcet;
+
+		if (s->target == RTS_SENS_ALL || s->target == i) {
+			/* Keep 1.0 * C at C despite rounding in alpha */
+			double c = ceil(alpha * wcet - 1e-9);
+			wcet = c < 1.0 ? 1 : (int)c;
+		}
+
+		t->wcet = wcet;
+		t->util = (double)wcet / t->period;
+		util += t->util;
+	}
+
+	return util;
+}
+
+/**
+ * sens_overloaded - whether the scratch WCETs demand more than one processor
+ * @util: their utilization as returned by sens_scale()
+ *
+ * Rounding WCETs up can push utilization past 1 below sens_limit(), and a
+ * phased set may not miss within the simulated horizon even then, so this
+ * is checked before any probe.  Exact over the hyperperiod when it is
+ * known.
+ */
+static int sens_overloaded(const struct rts_sens *s, double util) {
+	rts_time_t demand = 0;
+
+	if (!s->sim_ok)
+		return util > 1.0 + SENS_UTIL_EPS;
+
+	for (int i = 0; i < s->n_tasks; i++) {
+		rts_time_t share = s->lcm / s->scaled[i].period;
+
+		if (share > (s->lcm - demand) / s->scaled[i].wcet)
+			return 1;
+		demand += share * s->scaled[i].wcet;
+	}
+	return 0;
+}
+
+/**
+ * sens_simulate - event-driven run of the scratch task set that stops at
+ * the first deadline miss
+ *
+ * Returns 1 if no job missed, 0 if one did, -1 if the run cannot start.
+ */
+static int sens_simulate(struct rts_sens *s, const struct rts_sched_class *sched) {
+	struct rts_sim sim = {
+	    .tasks = s->scaled,
+	    .n_tasks = s->n_tasks,
+	    .rq_ops = s->rq_ops,
+	    .switch_cost = s->switch_cost,
+	};
+	rts_time_t end = s->lcm + s->max_phase;
+
+	/* rts_calendar_init() recomputes next_release from the phase */
+	for (int i = 0; i < s->n_tasks; i++) {
+		s->scaled[i].release_count = 0;
+		s->scaled[i].preemptions = 0;
+		s->scaled[i].migrations = 0;
+	}
+
+	if (rts_sim_start(&sim, sched) != 0)
+		return -1;
+
+	while (sim.clock < end && sim.missed_jobs == 0)
+		rts_sim_step(&sim, sched, RTS_ENGINE_EVENT, end);
+	rts_sim_finish(&sim);
+
+	return sim.missed_jobs == 0;
+}
+
+/**
+ * sens_probe - whether the task set scaled by @alpha is schedulable
+ *
+ * Returns 1 or 0, or -1 if it cannot be decided.
+ */
+static int sens_probe(struct rts_sens *s, const struct rts_sched_class *sched,
+                      double alpha, struct rts_sens_result *res) {
+	double util = sens_scale(s, alpha);
+
+	res->probes++;
+
+	if (sens_overloaded(s, util))
+		return 0;
+	if (res->analytic)
+		return sched->analyze(s->scaled, s->n_tasks, NULL) != 0;
+
+	if (!s->sim_ok)
+		return -1;
+	return sens_simulate(s, sched);
+}
+
+/**
+ * sens_limit - factor at which utilization reaches 1, which no policy can
+ * exceed on one processor
+ */
+static double sens_limit(const struct rts_sens *s) {
+	double util = 0.0, part = 0.0;
+
+	for (int i = 0; i < s->n_tasks; i++) {
+		double u = (double)s->tasks[i].wcet / s->tasks[i].period;
+
+		util += u;
+		if (s->target == RTS_SENS_ALL || s->target == i)
+			part += u;
+	}
+
+	if (part <= 0.0)
+		return 0.0;
+	return (1.0 - (util - part)) / part;
+}
+
+int rts_sens_search(struct rts_sens *s, const struct rts_sched_class *sched,
+                    struct rts_sens_result *res) {
+	double lo = 0.0, hi = sens_limit(s);
+	int ok;
+
+	*res = (struct rts_sens_result){
+	    .limit = hi,
+	    .analytic = sched->analyze && s->sync && !s->switch_cost,
+	};
+
+	if (hi > 0.0) {
+		ok = sens_probe(s, sched, hi, res);
+		if (ok < 0)
+			return -1;
+		if (ok)
+			lo = hi;
+	}
+
+	while (hi - lo > RTS_SENS_EPS * res->limit) {
+		double mid = lo + (hi - lo) / 2;
+
+		ok = sens_probe(s, sched, mid, res);
+		if (ok < 0)
+			return -1;
+		if (ok)
+			lo = mid;
+		else
+			hi = mid;
+	}
+
+	res->factor = lo;
+	res->util = lo > 0.0 ? sens_scale(s, lo) : 0.0;
+	return 0;
+}
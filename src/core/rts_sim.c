@@ -3,17 +3,582 @@
  * @file rts_sim.c
  * @brief Main simulation loop for RTOS scheduling.
  */
+#include "rts_calendar.h"
+#include "rts_cycle.h"
+#include "rts_hist.h"
+#include "rts_job_pool.h"
 #include "rts_rq.h"
 #include "rts_sched.h"
+#include "rts_sim.h"
+#include "rts_stats.h"
+#include "rts_trace.h"
 #include "rts_types.h"
 #include "rts_util.h"
 #include "rts_log.h"
 
+#include <inttypes.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+static void rts_sim_cleanup_queues(struct rts_sim *sim);
 static void rts_sim_cleanup(struct rts_sim *sim);
 
+/* Call hook @ev of @sim, if set */
+#define RTS_SIM_HOOK(sim, ev, job, t)                                 \
+	do {                                                          \
+		if ((sim)->hooks && (sim)->hooks->ev)                 \
+			(sim)->hooks->ev((sim)->hooks->ctx, (job), (t)); \
+	} while (0)
+
+int rts_sim_horizon(const struct rts_task *tasks, int n_tasks,
+                    rts_time_t *lcm, rts_time_t *max_phase, int steady) {
+	rts_time_t hp = n_tasks > 0 ? tasks[0].period : 1;
+	rts_time_t mp = 0;
+
+	for (int i = 0; i < n_tasks; i++) {
+		if (i > 0 && rts_util_lcm(hp, tasks[i].period, &hp) != 0)
+			return -1;
+
+		if (tasks[i].phase > mp)
+			mp = tasks[i].phase;
+	}
+
+	*lcm = hp;
+	*max_phase = mp;
+
+	/* The longest run, plus one relative deadline, must not wrap */
+	if (hp > (RTS_TIME_MAX - INT_MAX - mp) / (steady ? RTS_SIM_STEADY_MAX_CYCLES : 1))
+		return -1;
+
+	return 0;
+}
+
+int rts_engine_from_name(const char *name) {
+	if (!name)
+		return -1;
+	if (strcmp(name, "tick") == 0)
+		return RTS_ENGINE_TICK;
+	if (strcmp(name, "event") == 0)
+		return RTS_ENGINE_EVENT;
+	return -1;
+}
+
+static void rts_sim_banner(const struct rts_sim *sim,
+                           const struct rts_sched_class *sched) {
+	struct rts_log *log = sim->log;
+
+	if (!RTS_LOG_ENABLED(log, RTS_LOG_SUMMARY))
+		return;
+
+	rts_log_printf(log, "Starting simulation with %s policy\n", sched->name);
+	rts_log_printf(log, "Loaded %d tasks:\n", sim->n_tasks);
+
+	for (int i = 0; i < sim->n_tasks; i++) {
+		struct rts_task *t = &sim->tasks[i];
+		rts_log_printf(log, "T%d: phase=%d, period=%d, deadline=%d, wcet=%d, util=%.2f\n",
+		               t->tid + 1, t->phase, t->period, t->rel_deadline, t->wcet, t->util);
+	}
+	rts_log_printf(log, "\n--------------------------------------------\n\n");
+}
+
+static void rts_sim_summary(const struct rts_sim *sim) {
+	struct rts_log *log = sim->log;
+
+	if (!RTS_LOG_ENABLED(log, RTS_LOG_SUMMARY))
+		return;
+
+	rts_log_printf(log, "--------------------------------------------\n");
+	rts_log_printf(log, "Simulation complete.\n");
+	rts_log_printf(log, "Total jobs released: %" PRId64 "\n", sim->total_jobs);
+	rts_log_printf(log, "Missed deadlines: %" PRId64 "\n", sim->missed_jobs);
+	rts_log_printf(log, "Preemptions: %ld\n", sim->preemptions);
+	rts_log_printf(log, "Context switches: %ld\n", sim->switches);
+	if (sim->switch_cost)
+		rts_log_printf(log, "Switch overhead: %" PRId64 " (%d per preemption)\n",
+		               sim->overhead, sim->switch_cost);
+
+	if (!sim->steady)
+		return;
+
+	if (sim->cycle_len)
+		rts_log_printf(log, "Steady state: repeats every %" PRId64 " from t=%" PRId64 "\n",
+		               sim->cycle_len, sim->cycle_start);
+	else
+		rts_log_printf(log, "Steady state: not reached\n");
+}
+
+/**
+ * rts_sim_report - append the JSON run report, after queued log records
+ * when both share a stream
+ */
+static void rts_sim_report(const struct rts_sim *sim,
+                           const struct rts_sched_class *sched, int n_cpus) {
+	if (!sim->report)
+		return;
+
+	if (sim->log && sim->log->fp == sim->report)
+		rts_log_sync(sim->log);
+	rts_stats_report(sim->report, sim, sched, n_cpus);
+}
+
+/**
+ * rts_sim_dump - print the ready queue at full verbosity
+ */
+static inline void rts_sim_dump(struct rts_sim *sim) {
+	if (RTS_LOG_ENABLED(sim->log, RTS_LOG_FULL))
+		rts_rq_print(&sim->ready_queue, sim->log);
+}
+
+/**
+ * rts_sim_job_late - count @job as a miss if it missed or can no longer
+ * meet its deadline at the current clock
+ *
+ * Returns 1 if the caller must drop the job.
+ */
+static int rts_sim_job_late(struct rts_sim *sim, const struct rts_job *job) {
+	if (job->remain <= 0)
+		return 0;
+
+	// Deadline miss detected
+	if (sim->clock >= job->abs_deadline) {
+		RTS_LOG_MISS(sim->log, "T%d:J%d missed its deadline (t=%" PRId64 ", d=%" PRId64 ")\n",
+		       job->tid + 1, job->jid, sim->clock, job->abs_deadline);
+	}
+	// Not enough time to finish before deadline
+	else if (sim->clock + job->remain > job->abs_deadline) {
+		RTS_LOG_MISS_IMMINENT(sim->log, "T%d:J%d cannot meet deadline (t=%" PRId64 ", d=%" PRId64 ", rem=%d)\n",
+		       job->tid + 1, job->jid, sim->clock, job->abs_deadline, job->remain);
+	} else {
+		return 0;
+	}
+
+	sim->missed_jobs++;
+	if (job == sim->last)
+		sim->last = NULL;
+	RTS_SIM_HOOK(sim, miss, job, sim->clock);
+	return 1;
+}
+
+/**
+ * rts_sim_check_misses - drop queued jobs that missed or can no longer
+ * meet their deadline at the current clock
+ *
+ * Late jobs are the ones whose latest feasible start has passed, so only
+ * those are taken from the deadline index, earliest first; the rest of
+ * the queue is not touched.
+ */
+static void rts_sim_check_misses(struct rts_sim *sim) {
+	struct rts_job *job;
+
+	while ((job = rts_rq_dl_first(&sim->ready_queue)) &&
+	       job->abs_deadline - job->remain < sim->clock) {
+		rts_sim_job_late(sim, job);
+		rts_rq_erase(&sim->ready_queue, job);
+		rts_job_pool_free(&sim->job_pool, job);
+	}
+}
+
+/**
+ * rts_sim_release_one - release job @jid of task @t at the current clock
+ */
+static void rts_sim_release_one(struct rts_sim *sim,
+                                const struct rts_sched_class *sched,
+                                const struct rts_task *t, int jid) {
+	struct rts_job *j = rts_job_pool_alloc(&sim->job_pool);
+	if (!j) {
+		fprintf(stderr, "[sim] out of memory releasing T%d\n", t->tid + 1);
+		exit(EXIT_FAILURE);
+	}
+	rts_stats_alloc(&sim->stats);
+
+	j->tid = t->tid;
+	j->jid = jid;
+	j->remain = t->wcet;
+	j->abs_deadline = sim->clock + t->rel_deadline;
+	j->release_time = sim->clock;
+	j->start = -1;
+	j->cpu = -1;
+
+	if (sched->enqueue) {
+		sched->enqueue(sim, j);
+	} else {
+		rts_sched_default_enqueue(sim, j, sched);
+	}
+
+	sim->total_jobs++;
+	RTS_SIM_HOOK(sim, release, j, sim->clock);
+
+	RTS_LOG_ARRIVAL(sim->log, "T%d:J%d (release=%" PRId64 ", deadline=%" PRId64 ")\n",
+	       j->tid + 1, j->jid, j->release_time, j->abs_deadline);
+}
+
+/**
+ * rts_sim_release_jobs - release every task whose period starts now
+ *
+ * The release calendar yields due tasks in tid order, so only tasks that
+ * actually release are touched.
+ */
+static void rts_sim_release_jobs(struct rts_sim *sim,
+                                 const struct rts_sched_class *sched) {
+	int i;
+
+	while ((i = rts_calendar_due(&sim->calendar, sim->tasks, sim->clock)) >= 0) {
+		struct rts_task *t = &sim->tasks[i];
+
+		rts_sim_release_one(sim, sched, t, (int)++t->release_count);
+		rts_calendar_advance(&sim->calendar, sim->tasks);
+	}
+}
+
+/**
+ * rts_sim_setup_queues - let the policy derive its per-task state, prepare
+ * the job pool and bind the ready queue to the chosen backend
+ */
+static int rts_sim_setup_queues(struct rts_sim *sim,
+                                const struct rts_sched_class *sched) {
+	if (sched->prepare && sched->prepare(sim->tasks, sim->n_tasks) != 0) {
+		fprintf(stderr, "Error: cannot prepare the %s policy\n", sched->name);
+		return -1;
+	}
+
+	rts_job_pool_init(&sim->job_pool);
+	sim->last = NULL;
+	memset(&sim->stats, 0, sizeof(sim->stats));
+
+	if (rts_rq_setup(&sim->ready_queue, sim->rq_ops, sched,
+	                 sim->tasks, &sim->clock) != 0) {
+		fprintf(stderr, "Error: cannot initialize ready queue\n");
+		return -1;
+	}
+	sim->ready_queue.stats = &sim->stats;
+
+	return 0;
+}
+
+/**
+ * rts_sim_setup - prepare the release calendar and per-policy queues
+ */
+static int rts_sim_setup(struct rts_sim *sim,
+                         const struct rts_sched_class *sched) {
+	if (rts_calendar_init(&sim->calendar, sim->tasks, sim->n_tasks,
+	                      sim->clock) != 0) {
+		fprintf(stderr, "Error: cannot initialize release calendar\n");
+		return -1;
+	}
+
+	if (rts_sim_setup_queues(sim, sched) != 0) {
+		rts_calendar_destroy(&sim->calendar);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * rts_sim_account - charge @ran time units to @cur
+ *
+ * Removes the job once it has finished; otherwise lets the ready queue
+ * reorder it, as its remaining time is part of some policies' key.
+ */
+static void rts_sim_account(struct rts_sim *sim, struct rts_job *cur, int ran) {
+	cur->remain -= ran;
+
+	if (cur->remain == 0) {
+		if (sim->task_stats)
+			rts_task_stats_record(&sim->task_stats[cur->tid], cur, sim->clock + ran);
+		RTS_SIM_HOOK(sim, complete, cur, sim->clock + ran);
+		rts_rq_erase(&sim->ready_queue, cur);
+		rts_job_pool_free(&sim->job_pool, cur);
+	} else {
+		rts_rq_update(&sim->ready_queue, cur);
+	}
+}
+
+/**
+ * rts_sim_end_boundary - log the state at the end time, where only the
+ * deadline check runs
+ */
+static void rts_sim_end_boundary(struct rts_sim *sim) {
+	RTS_LOG_END(sim->log, "\n[%03" PRId64 "]\n", sim->clock);
+	rts_sim_dump(sim);
+}
+
+/**
+ * rts_sim_switch_to - dispatch @cur (NULL: idle) at the current clock
+ *
+ * The job that ran before counts as preempted if it is unfinished and is
+ * not the one that continues, and the job taking its place is charged the
+ * switch cost.  That happens before the step is sized, so the overhead
+ * delays completions and deadline checks like any other work.  Every
+ * change of job is a context switch.
+ */
+static void rts_sim_switch_to(struct rts_sim *sim, struct rts_job *cur) {
+	if (sim->last && sim->last != cur) {
+		sim->preemptions++;
+		sim->tasks[sim->last->tid].preemptions++;
+
+		if (cur && sim->switch_cost) {
+			cur->remain += sim->switch_cost;
+			sim->overhead += sim->switch_cost;
+			rts_rq_update(&sim->ready_queue, cur);
+		}
+	}
+	if (cur && cur != sim->last) {
+		sim->switches++;
+		if (cur->start < 0)
+			cur->start = sim->clock;
+		RTS_SIM_HOOK(sim, dispatch, cur, sim->clock);
+	}
+}
+
+/**
+ * rts_sim_ran - note that @cur (NULL: idle) runs for the next @len time
+ * units, before they are accounted
+ */
+static inline void rts_sim_ran(struct rts_sim *sim, struct rts_job *cur, rts_time_t len) {
+	rts_stats_step(&sim->stats, len, !cur);
+
+	sim->last = (cur && cur->remain > len) ? cur : NULL;
+}
+
+/**
+ * rts_sim_exec_tick - execute @cur (or idle) for one time unit
+ */
+static void rts_sim_exec_tick(struct rts_sim *sim, struct rts_job *cur) {
+	rts_sim_ran(sim, cur, 1);
+
+	if (cur) {
+		RTS_LOG_RUN(sim->log, sim->clock,
+		            "T%d:J%d (remain=%d)",
+		            cur->tid + 1, cur->jid, cur->remain - 1);
+
+		if (sim->trace)
+			rts_trace_emit(sim->trace, sim->clock, sim->clock + 1, cur->tid, cur->jid);
+
+		if (cur->remain == 1) {
+			RTS_LOG_DONE(sim->log, "T%d:J%d finished at t=%" PRId64 "\n",
+			       cur->tid + 1, cur->jid, sim->clock + 1);
+		}
+
+		rts_sim_account(sim, cur, 1);
+	} else {
+		RTS_LOG_RUN(sim->log, sim->clock, "IDLE\n");
+		if (sim->trace)
+			rts_trace_emit(sim->trace, sim->clock, sim->clock + 1, -1, 0);
+	}
+
+	rts_sim_dump(sim);
+}
+
+/**
+ * rts_sim_exec_segment - execute @cur (or idle) from the clock up to @next
+ */
+static void rts_sim_exec_segment(struct rts_sim *sim, struct rts_job *cur,
+                                 rts_time_t next) {
+	rts_time_t len = next - sim->clock;
+
+	rts_sim_ran(sim, cur, len);
+
+	if (cur) {
+		RTS_LOG_RUN(sim->log, sim->clock,
+		            "T%d:J%d x%" PRId64 " (remain=%" PRId64 ")",
+		            cur->tid + 1, cur->jid, len, cur->remain - len);
+
+		if (sim->trace)
+			rts_trace_emit(sim->trace, sim->clock, next, cur->tid, cur->jid);
+
+		if (cur->remain == len) {
+			RTS_LOG_DONE(sim->log, "T%d:J%d finished at t=%" PRId64 "\n",
+			       cur->tid + 1, cur->jid, next);
+		}
+
+		/* A segment never outlasts the job, so len fits in remain */
+		rts_sim_account(sim, cur, (int)len);
+	} else {
+		RTS_LOG_RUN(sim->log, sim->clock, "IDLE x%" PRId64 "\n", len);
+		if (sim->trace)
+			rts_trace_emit(sim->trace, sim->clock, next, -1, 0);
+	}
+
+	rts_sim_dump(sim);
+}
+
+/**
+ * rts_sim_end_time - reset steady-state detection and return the last
+ * time point to simulate
+ *
+ * Steady-state runs may go on for RTS_SIM_STEADY_MAX_CYCLES hyperperiods
+ * past the largest phase, but normally stop at the first repeated
+ * boundary state.
+ */
+static rts_time_t rts_sim_end_time(struct rts_sim *sim, struct rts_cycle *cyc,
+                                   rts_time_t lcm, rts_time_t max_phase) {
+	sim->cycle_start = 0;
+	sim->cycle_len = 0;
+	rts_cycle_init(cyc, lcm);
+
+	if (sim->steady)
+		return max_phase + RTS_SIM_STEADY_MAX_CYCLES * lcm;
+
+	return lcm + max_phase;
+}
+
+/**
+ * rts_sim_steady - at a hyperperiod boundary, check whether the schedule
+ * repeats one seen at an earlier boundary
+ *
+ * Returns 1 if the run can stop here.
+ */
+static int rts_sim_steady(struct rts_sim *sim, struct rts_cycle *cyc) {
+	if (!sim->steady || !rts_cycle_boundary(cyc, sim->clock))
+		return 0;
+
+	rts_time_t prev = rts_cycle_check(cyc, sim);
+	if (prev < 0)
+		return 0;
+
+	sim->cycle_start = prev;
+	sim->cycle_len = sim->clock - prev;
+
+	RTS_LOG_INFO(sim->log, "\n[ STEADY ] state at t=%" PRId64 " repeats t=%" PRId64 "\n",
+	             sim->clock, prev);
+	return 1;
+}
+
+/**
+ * rts_sim_next_event - time of the next point where the tick engine could
+ * make a different decision than "run @cur again"
+ * @sim: simulation context
+ * @sched: scheduler class
+ * @cur: job selected at the current clock (NULL when idle)
+ * @next_release: time of the next job release
+ * @end: simulation end time
+ *
+ * Candidates are the end time, the next release, the completion of @cur,
+ * the imminent-miss point of every waiting job (which never moves while it
+ * waits; the earliest comes from the deadline index) and, for
+ * dynamic-priority classes, the time a waiting job may outrank @cur.  The
+ * result is clamped to > sim->clock.
+ */
+static rts_time_t rts_sim_next_event(const struct rts_sim *sim,
+                                     const struct rts_sched_class *sched,
+                                     const struct rts_job *cur,
+                                     rts_time_t next_release, rts_time_t end) {
+	rts_time_t next = rts_min_i64(end, next_release);
+
+	if (cur) {
+		next = rts_min_i64(next, sim->clock + cur->remain);
+
+		// Infeasible running job: the miss check catches it next tick
+		if (sim->clock + cur->remain > cur->abs_deadline)
+			return sim->clock + 1;
+	}
+
+	rts_time_t lfs = rts_rq_dl_next(&sim->ready_queue, cur);
+	if (lfs < next)
+		next = lfs + 1;
+
+	if (cur && sched->preempt_at)
+		next = rts_min_i64(next, sched->preempt_at(cur, &sim->ready_queue, sim->tasks, sim->clock));
+
+	// Jobs released infeasible at this tick are only checked on the next one
+	return rts_max_i64(next, sim->clock + 1);
+}
+
+/**
+ * rts_sim_start - prepare @sim to be stepped from its clock
+ *
+ * Deadlines at the start time are checked here; each step checks them at
+ * the time it reaches, so the state between steps is always settled.
+ */
+int rts_sim_start(struct rts_sim *sim, const struct rts_sched_class *sched) {
+	if (rts_sim_setup(sim, sched) != 0)
+		return -1;
+
+	rts_sim_check_misses(sim);
+	return 0;
+}
+
+int rts_sim_resume(struct rts_sim *sim, const struct rts_sched_class *sched) {
+	if (rts_calendar_build(&sim->calendar, sim->tasks, sim->n_tasks) != 0) {
+		fprintf(stderr, "Error: cannot initialize release calendar\n");
+		return -1;
+	}
+
+	if (rts_sim_setup_queues(sim, sched) != 0) {
+		rts_calendar_destroy(&sim->calendar);
+		return -1;
+	}
+
+	return 0;
+}
+
+void rts_sim_step(struct rts_sim *sim, const struct rts_sched_class *sched,
+                  int engine, rts_time_t until) {
+	// New job arrivals
+	rts_sim_release_jobs(sim, sched);
+
+	// Select the job to run and execute it up to the next decision point
+	struct rts_job *cur = rts_rq_peek(&sim->ready_queue);
+	rts_sim_switch_to(sim, cur);
+
+	if (engine == RTS_ENGINE_EVENT) {
+		rts_time_t next = rts_sim_next_event(sim, sched, cur,
+		                                     rts_calendar_next(&sim->calendar, sim->tasks),
+		                                     until);
+
+		rts_sim_exec_segment(sim, cur, next);
+		sim->clock = next;
+	} else {
+		rts_sim_exec_tick(sim, cur);
+		sim->clock++;
+	}
+
+	// Check for deadline misses
+	rts_sim_check_misses(sim);
+}
+
+void rts_sim_finish(struct rts_sim *sim) {
+	rts_sim_cleanup(sim);
+}
+
+/**
+ * rts_sim_run_engine - run @sim with @engine from start to end time
+ *
+ * At the end time (or a repeated boundary) only the deadline check runs.
+ */
+static void rts_sim_run_engine(struct rts_sim *sim,
+                               const struct rts_sched_class *sched, int engine,
+                               rts_time_t lcm, rts_time_t max_phase) {
+	struct rts_cycle cyc;
+	rts_time_t end = rts_sim_end_time(sim, &cyc, lcm, max_phase);
+
+	rts_sim_banner(sim, sched);
+
+	if (rts_sim_start(sim, sched) != 0) {
+		rts_cycle_destroy(&cyc);
+		return;
+	}
+
+	while (sim->clock < end && !rts_sim_steady(sim, &cyc)) {
+		// Boundaries are events too when the state is sampled there
+		rts_time_t stop = end;
+		if (sim->steady)
+			stop = rts_min_i64(end, rts_cycle_next_boundary(&cyc, sim->clock));
+
+		rts_sim_step(sim, sched, engine, stop);
+	}
+	rts_sim_end_boundary(sim);
+
+	rts_cycle_destroy(&cyc);
+	rts_sim_finish(sim);
+
+	rts_sim_summary(sim);
+	rts_sim_report(sim, sched, 1);
+}
+
 /**
  * rts_sim_run - main simulation loop
  * @sim: simulation context
@@ -23,153 +588,452 @@ static void rts_sim_cleanup(struct rts_sim *sim);
  */
 void rts_sim_run(struct rts_sim *sim,
                  const struct rts_sched_class *sched,
-                 int lcm, int max_phase) {
-	printf("Starting simulation with %s policy\n", sched->name);
-	printf("Loaded %d tasks:\n", sim->n_tasks);
+                 rts_time_t lcm, rts_time_t max_phase) {
+	rts_sim_run_engine(sim, sched, RTS_ENGINE_TICK, lcm, max_phase);
+}
 
-	for (int i = 0; i < sim->n_tasks; i++) {
-		struct rts_task *t = &sim->tasks[i];
-		printf("T%d: phase=%d, period=%d, deadline=%d, wcet=%d, util=%.2f\n",
-		       t->tid + 1, t->phase, t->period, t->rel_deadline, t->wcet, t->util);
-	}
-	printf("\n--------------------------------------------\n\n");
-
-	rts_rq_init(&sim->ready_queue);
-
-	while (sim->clock <= (lcm + max_phase)) {
-		// Check for deadline misses
-		struct rts_list_head *p, *n;
-		rts_list_for_each_safe(p, n, &sim->ready_queue) {
-			struct rts_job *job = rts_list_entry(p, struct rts_job, qnode);
-
-			if (job->remain <= 0) {
-				continue;
-			}
-
-			// Deadline miss detected
-			if (sim->clock >= job->abs_deadline) {
-				RTS_LOG_MISS("T%d:J%d missed its deadline (t=%d, d=%d)\n",
-				       job->tid + 1, job->jid, sim->clock, job->abs_deadline);
-				
-				sim->missed_jobs++;
-				rts_rq_remove(job);
-				free(job);
-				continue;
-			}
-
-			// Not enough time to finish before deadline
-			if (sim->clock + job->remain > job->abs_deadline) {
-				RTS_LOG_MISS_IMMINENT("T%d:J%d cannot meet deadline (t=%d, d=%d, rem=%d)\n",
-				       job->tid + 1, job->jid, sim->clock, job->abs_deadline, job->remain);
-				
-				sim->missed_jobs++;
-				rts_rq_remove(job);
-				free(job);
-				continue;
-			}
-
-			// int slack = job->abs_dead - sim->clock - job->remain;
-			// if (slack < 0) {
-			// 	printf("[LST] Job T%d missed deadline (d=%d, now=%d, remain=%d, slack=%d)\n",
-			// 	       job->tid, job->abs_dead, sim->clock, job->remain, slack);
-			// 	sim->missed_jobs++;
-			// 	rts_rq_remove(job);
-			// 	free(job);
-			// }
-		}
-
-		// Skip job arrivals and execution at the end time
-		// no job arrivals or execution, only check deadline misses
-		if (sim->clock == (lcm + max_phase)) {
-			RTS_LOG_END("\n[%03d]\n", sim->clock);
-			rts_rq_dump(&sim->ready_queue, sim->tasks);
-			sim->clock++;
+/**
+ * rts_sim_run_event - discrete-event simulation loop
+ * @sim: simulation context
+ * @sched: chosen scheduler class
+ * @lcm: total hyperperiod
+ * @max_phase: max phase offset
+ *
+ * Runs the selected job (or idles) for a whole segment up to the next
+ * event instead of one tick at a time.  Within a segment no release,
+ * completion or deadline check occurs and the selection is unchanged, so
+ * the outcome matches rts_sim_run().
+ */
+void rts_sim_run_event(struct rts_sim *sim,
+                       const struct rts_sched_class *sched,
+                       rts_time_t lcm, rts_time_t max_phase) {
+	rts_sim_run_engine(sim, sched, RTS_ENGINE_EVENT, lcm, max_phase);
+}
+
+/**
+ * struct rts_gcpus - processors of a global run
+ * @sched: policy; its higher_prio() also orders the running jobs
+ * @sim:   simulation (for the task set and clock)
+ * @job:   job on each CPU (NULL: idle)
+ * @heap:  busy CPUs, the one running the lowest-priority job at the root
+ * @pos:   slot of each busy CPU in @heap
+ * @nr:    number of busy CPUs
+ * @m:     number of CPUs
+ *
+ * Running jobs are taken out of the ready queue, which then holds only
+ * waiting jobs.  The top-M set changes only when the best waiting job
+ * beats the worst running one, so each change costs O(log M + log n).
+ */
+struct rts_gcpus {
+	const struct rts_sched_class *sched;
+	struct rts_sim *sim;
+	struct rts_job **job;
+	int *heap;
+	int *pos;
+	int nr;
+	int m;
+};
+
+static int rts_gcpus_init(struct rts_gcpus *g, int m,
+                          const struct rts_sched_class *sched,
+                          struct rts_sim *sim) {
+	g->sched = sched;
+	g->sim = sim;
+	g->job = calloc((size_t)m, sizeof(*g->job));
+	g->heap = malloc(sizeof(*g->heap) * (size_t)m);
+	g->pos = malloc(sizeof(*g->pos) * (size_t)m);
+	g->nr = 0;
+	g->m = m;
+
+	if (!g->job || !g->heap || !g->pos) {
+		free(g->pos);
+		free(g->heap);
+		free(g->job);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void rts_gcpus_destroy(struct rts_gcpus *g) {
+	free(g->pos);
+	free(g->heap);
+	free(g->job);
+}
+
+/* True if the job on CPU @a should give way before the one on CPU @b */
+static inline int rts_gcpus_below(const struct rts_gcpus *g, int a, int b) {
+	rts_stats_cmp(&g->sim->stats);
+	return rts_sched_higher(g->sched, g->job[b], g->job[a], g->sim->tasks, g->sim->clock);
+}
+
+static inline void rts_gcpus_set(struct rts_gcpus *g, int i, int c) {
+	g->heap[i] = c;
+	g->pos[c] = i;
+}
+
+static void rts_gcpus_sift_up(struct rts_gcpus *g, int i) {
+	int c = g->heap[i];
+
+	while (i > 0) {
+		int parent = (i - 1) / 2;
+
+		if (!rts_gcpus_below(g, c, g->heap[parent]))
+			break;
+		rts_gcpus_set(g, i, g->heap[parent]);
+		i = parent;
+	}
+	rts_gcpus_set(g, i, c);
+}
+
+static void rts_gcpus_sift_down(struct rts_gcpus *g, int i) {
+	int c = g->heap[i];
+
+	for (;;) {
+		int child = 2 * i + 1;
+
+		if (child >= g->nr)
+			break;
+		if (child + 1 < g->nr && rts_gcpus_below(g, g->heap[child + 1], g->heap[child]))
+			child++;
+		if (!rts_gcpus_below(g, g->heap[child], c))
+			break;
+		rts_gcpus_set(g, i, g->heap[child]);
+		i = child;
+	}
+	rts_gcpus_set(g, i, c);
+}
+
+static void rts_gcpus_add(struct rts_gcpus *g, int c, struct rts_job *job) {
+	g->job[c] = job;
+	rts_gcpus_set(g, g->nr++, c);
+	rts_gcpus_sift_up(g, g->nr - 1);
+}
+
+/**
+ * rts_gcpus_vacate - take the job off CPU @c and return it
+ */
+static struct rts_job *rts_gcpus_vacate(struct rts_gcpus *g, int c) {
+	struct rts_job *job = g->job[c];
+	int i = g->pos[c];
+
+	g->nr--;
+	if (i != g->nr) {
+		int moved = g->heap[g->nr];
+
+		rts_gcpus_set(g, i, moved);
+		rts_gcpus_sift_down(g, i);
+		rts_gcpus_sift_up(g, g->pos[moved]);
+	}
+	g->job[c] = NULL;
+
+	return job;
+}
+
+/**
+ * rts_sim_global_dispatch - run the M highest-priority jobs
+ *
+ * A job resumes on the CPU it last ran on if that CPU is free, else on
+ * the lowest-numbered free one; resuming elsewhere is a migration.  A job
+ * that preempts another is charged the switch cost.
+ */
+static void rts_sim_global_dispatch(struct rts_sim *sim, struct rts_gcpus *g) {
+	struct rts_job *w;
+
+	while ((w = rts_rq_peek(&sim->ready_queue))) {
+		int preempt = g->nr == g->m;
+
+		if (preempt) {
+			int low = g->heap[0];
+
+			rts_stats_cmp(&sim->stats);
+			if (!rts_sched_higher(g->sched, w, g->job[low], sim->tasks, sim->clock))
+				break;
+
+			struct rts_job *out = rts_gcpus_vacate(g, low);
+			rts_rq_insert(&sim->ready_queue, out);
+			sim->preemptions++;
+			sim->tasks[out->tid].preemptions++;
+		}
+
+		rts_rq_erase(&sim->ready_queue, w);
+		if (preempt) {
+			w->remain += sim->switch_cost;
+			sim->overhead += sim->switch_cost;
+		}
+
+		int c = w->cpu;
+		if (c < 0 || g->job[c]) {
+			for (c = 0; g->job[c]; c++)
+				;
+		}
+
+		if (w->cpu >= 0 && w->cpu != c) {
+			sim->migrations++;
+			sim->tasks[w->tid].migrations++;
+		}
+		w->cpu = c;
+		/* Before it is ranked among the running jobs: starting may boost it */
+		if (w->start < 0)
+			w->start = sim->clock;
+		sim->switches++;
+		rts_gcpus_add(g, c, w);
+		RTS_SIM_HOOK(sim, dispatch, w, sim->clock);
+	}
+}
+
+/**
+ * rts_sim_global_check_misses - drop late jobs, waiting or running
+ */
+static void rts_sim_global_check_misses(struct rts_sim *sim, struct rts_gcpus *g) {
+	rts_sim_check_misses(sim);
+
+	for (int c = 0; c < g->m; c++) {
+		if (g->job[c] && rts_sim_job_late(sim, g->job[c]))
+			rts_job_pool_free(&sim->job_pool, rts_gcpus_vacate(g, c));
+	}
+}
+
+/**
+ * rts_sim_global_next_event - like rts_sim_next_event() for every CPU
+ *
+ * Priorities are fixed per job, so the running set changes only on a
+ * release, a completion or a dropped job.
+ */
+static rts_time_t rts_sim_global_next_event(const struct rts_sim *sim,
+                                            const struct rts_gcpus *g,
+                                            rts_time_t next_release, rts_time_t end) {
+	rts_time_t next = rts_min_i64(end, next_release);
+
+	for (int c = 0; c < g->m; c++) {
+		const struct rts_job *cur = g->job[c];
+
+		if (!cur)
+			continue;
+		if (sim->clock + cur->remain > cur->abs_deadline)
+			return sim->clock + 1;
+		next = rts_min_i64(next, sim->clock + cur->remain);
+	}
+
+	rts_time_t lfs = rts_rq_dl_next(&sim->ready_queue, NULL);
+	if (lfs < next)
+		next = lfs + 1;
+
+	return rts_max_i64(next, sim->clock + 1);
+}
+
+/**
+ * rts_sim_global_exec - run every CPU from the clock up to @next
+ */
+static void rts_sim_global_exec(struct rts_sim *sim, struct rts_gcpus *g, rts_time_t next) {
+	rts_time_t len = next - sim->clock;
+
+	rts_stats_step(&sim->stats, len, g->m - g->nr);
+
+	for (int c = 0; c < g->m; c++) {
+		struct rts_job *cur = g->job[c];
+
+		if (!cur) {
+			RTS_LOG_RUN(sim->log, sim->clock, "CPU%d IDLE x%" PRId64 "\n", c, len);
+			if (sim->trace)
+				rts_trace_emit(&sim->trace[c], sim->clock, next, -1, 0);
 			continue;
 		}
 
-		// New job arrivals
-		for (int i = 0; i < sim->n_tasks; i++) {
-			struct rts_task *t = &sim->tasks[i];
-			
-			if ((sim->clock - t->phase) >= 0 &&
-			    ((sim->clock - t->phase) % t->period) == 0) {
-
-				struct rts_job *j = calloc(1, sizeof(*j));
-				j->tid = t->tid;
-				j->jid = ++t->release_count;
-				j->remain = t->wcet;
-				j->abs_deadline = sim->clock + t->rel_deadline;
-				j->release_time = sim->clock;
-				rts_list_init(&j->qnode);
-
-				if (sched->enqueue) {
-    				sched->enqueue(sim, j);
-				} else {
-    				rts_sched_default_enqueue(sim, j, sched);
-				}
-
-				sim->total_jobs++;
-
-				RTS_LOG_ARRIVAL("T%d:J%d (release=%d, deadline=%d)\n",
-				       j->tid + 1, j->jid, j->release_time, j->abs_deadline);
-			}
-		}
-
-		// Select the job to run
-		struct rts_job *cur = NULL;
-		rts_list_for_each(p, &sim->ready_queue) {
-			struct rts_job *j = rts_list_entry(p, struct rts_job, qnode);
-			if (j->remain <= 0) {
-				continue;
-			}
-			if (!cur || sched->higher_prio(j, cur, sim->tasks, sim->clock)) {
-				cur = j;
-			}
-		}
-
-		// Execute the selected job for one time unit
-		if (cur) {
-			cur->remain--;
-			RTS_LOG_RUN(sim->clock,
-            			"T%d:J%d (remain=%d)",
-            			cur->tid + 1, cur->jid, cur->remain);
-
-			if (sim->trace_fp) {
-				fprintf(sim->trace_fp, "[%03d] T%d:J%d\n",
-				        sim->clock, cur->tid + 1, cur->jid);
-			}
-
-			if (cur->remain == 0) {
-				RTS_LOG_DONE("T%d:J%d finished at t=%d\n",
-				       cur->tid + 1, cur->jid, sim->clock + 1);
-				
-				rts_rq_remove(cur);
-				free(cur);
-			}
-		} else {
-			RTS_LOG_RUN(sim->clock, "IDLE\n");
-			fprintf(sim->trace_fp, "[%03d] IDLE\n", sim->clock);
-		}
-
-		rts_rq_dump(&sim->ready_queue, sim->tasks);
+		RTS_LOG_RUN(sim->log, sim->clock,
+		            "CPU%d T%d:J%d x%" PRId64 " (remain=%" PRId64 ")\n",
+		            c, cur->tid + 1, cur->jid, len, cur->remain - len);
+		if (sim->trace)
+			rts_trace_emit(&sim->trace[c], sim->clock, next, cur->tid, cur->jid);
 
-		sim->clock++;
+		/* Segments end at the earliest completion, so len fits in remain */
+		cur->remain -= (int)len;
+		if (cur->remain == 0) {
+			if (sim->task_stats)
+				rts_task_stats_record(&sim->task_stats[cur->tid], cur, next);
+			RTS_SIM_HOOK(sim, complete, cur, next);
+			RTS_LOG_DONE(sim->log, "T%d:J%d finished at t=%" PRId64 "\n",
+			       cur->tid + 1, cur->jid, next);
+			rts_job_pool_free(&sim->job_pool, rts_gcpus_vacate(g, c));
+		}
+	}
+
+	rts_sim_dump(sim);
+}
+
+void rts_sim_run_global(struct rts_sim *sim,
+                        const struct rts_sched_class *sched,
+                        int n_cpus, int engine,
+                        rts_time_t lcm, rts_time_t max_phase) {
+	rts_time_t end = lcm + max_phase;
+	struct rts_gcpus g;
+
+	sim->cycle_start = 0;
+	sim->cycle_len = 0;
+
+	if (rts_gcpus_init(&g, n_cpus, sched, sim) != 0) {
+		fprintf(stderr, "Error: cannot allocate %d CPUs\n", n_cpus);
+		return;
 	}
 
+	rts_sim_banner(sim, sched);
+
+	if (rts_sim_setup(sim, sched) != 0) {
+		rts_gcpus_destroy(&g);
+		return;
+	}
+
+	while (sim->clock <= end) {
+		rts_sim_global_check_misses(sim, &g);
+
+		if (sim->clock == end) {
+			rts_sim_end_boundary(sim);
+			break;
+		}
+
+		rts_sim_release_jobs(sim, sched);
+		rts_sim_global_dispatch(sim, &g);
+
+		rts_time_t next = sim->clock + 1;
+		if (engine == RTS_ENGINE_EVENT)
+			next = rts_sim_global_next_event(sim, &g,
+			                                 rts_calendar_next(&sim->calendar, sim->tasks),
+			                                 end);
+
+		rts_sim_global_exec(sim, &g, next);
+
+		sim->clock = next;
+	}
+
+	/* Running jobs belong to the job pool, which cleanup releases */
+	for (int c = 0; sim->trace && c < n_cpus; c++)
+		rts_trace_flush(&sim->trace[c]);
+
+	rts_gcpus_destroy(&g);
 	rts_sim_cleanup(sim);
 
-	printf("--------------------------------------------\n");
-	printf("Simulation complete.\n");
-	printf("Total jobs released: %d\n", sim->total_jobs);
-	printf("Missed deadlines: %d\n", sim->missed_jobs);
+	rts_sim_summary(sim);
+	RTS_LOG_INFO(sim->log, "Migrations: %ld\n", sim->migrations);
+	rts_sim_report(sim, sched, n_cpus);
 }
 
-static void rts_sim_cleanup(struct rts_sim *sim) {
-    struct rts_list_head *p, *n;
+/**
+ * rts_sim_run_lockstep - simulate several policies over one arrival stream
+ * @sims: one context per policy, all sharing the same task array
+ * @scheds: policy of each context
+ * @n: number of policies
+ * @engine: enum rts_engine
+ * @lcm: total hyperperiod
+ * @max_phase: max phase offset
+ *
+ * A single release calendar drives every context; each policy keeps its
+ * own ready queue, job pool, counters and trace.  Releases do not depend
+ * on the policy, so the per-policy results match separate runs.  With the
+ * event engine all contexts advance to the earliest of their next events.
+ */
+void rts_sim_run_lockstep(struct rts_sim *sims,
+                          const struct rts_sched_class *const *scheds,
+                          int n, int engine,
+                          rts_time_t lcm, rts_time_t max_phase) {
+	rts_time_t end = lcm + max_phase;
+	struct rts_task *tasks = sims[0].tasks;
+	rts_time_t clock = sims[0].clock;
+	struct rts_calendar cal;
+	int ready = 0;
+
+	struct rts_job **cur = malloc(sizeof(*cur) * n);
+	if (!cur || rts_calendar_init(&cal, tasks, sims[0].n_tasks, clock) != 0) {
+		fprintf(stderr, "Error: cannot initialize release calendar\n");
+		free(cur);
+		return;
+	}
+
+	for (; ready < n; ready++) {
+		sims[ready].clock = clock;
+		rts_sim_banner(&sims[ready], scheds[ready]);
+		if (rts_sim_setup_queues(&sims[ready], scheds[ready]) != 0)
+			goto out;
+	}
+
+	while (clock <= end) {
+		for (int k = 0; k < n; k++) {
+			sims[k].clock = clock;
+			rts_sim_check_misses(&sims[k]);
+		}
+
+		if (clock == end) {
+			for (int k = 0; k < n; k++)
+				rts_sim_end_boundary(&sims[k]);
+			clock++;
+			continue;
+		}
+
+		int i;
+		while ((i = rts_calendar_due(&cal, tasks, clock)) >= 0) {
+			struct rts_task *t = &tasks[i];
+			int jid = (int)++t->release_count;
+
+			for (int k = 0; k < n; k++)
+				rts_sim_release_one(&sims[k], scheds[k], t, jid);
+			rts_calendar_advance(&cal, tasks);
+		}
+
+		for (int k = 0; k < n; k++) {
+			cur[k] = rts_rq_peek(&sims[k].ready_queue);
+			rts_sim_switch_to(&sims[k], cur[k]);
+		}
+
+		rts_time_t next = clock + 1;
+		if (engine == RTS_ENGINE_EVENT) {
+			rts_time_t next_release = rts_calendar_next(&cal, tasks);
+
+			next = end;
+			for (int k = 0; k < n; k++)
+				next = rts_min_i64(next, rts_sim_next_event(&sims[k], scheds[k], cur[k],
+				                                            next_release, end));
+		}
+
+		for (int k = 0; k < n; k++) {
+			if (engine == RTS_ENGINE_EVENT)
+				rts_sim_exec_segment(&sims[k], cur[k], next);
+			else
+				rts_sim_exec_tick(&sims[k], cur[k]);
+		}
+
+		clock = next;
+	}
+
+out:
+	for (int k = 0; k < ready; k++) {
+		sims[k].clock = clock;
+		rts_sim_cleanup_queues(&sims[k]);
+		if (ready == n) {
+			rts_sim_summary(&sims[k]);
+			rts_sim_report(&sims[k], scheds[k], 1);
+		}
+	}
+
+	rts_calendar_destroy(&cal);
+	free(cur);
+}
+
+/**
+ * rts_sim_cleanup_queues - drop the remaining ready jobs
+ *
+ * Every job lives in the job pool, so releasing its slabs frees them all
+ * without walking the ready queue.
+ */
+static void rts_sim_cleanup_queues(struct rts_sim *sim) {
+    if (sim->trace)
+        rts_trace_flush(sim->trace);
+
+    rts_rq_init(&sim->ready_queue.jobs);
+    rts_rq_destroy(&sim->ready_queue);
 
-    rts_list_for_each_safe(p, n, &sim->ready_queue) {
-        struct rts_job *job = rts_list_entry(p, struct rts_job, qnode);
-        rts_rq_remove(job);
-        free(job);
-    }
+    rts_job_pool_destroy(&sim->job_pool);
+}
+
+static void rts_sim_cleanup(struct rts_sim *sim) {
+    rts_sim_cleanup_queues(sim);
+    rts_calendar_destroy(&sim->calendar);
 }
@@ -0,0 +1,377 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_snapshot.c
+ * @brief Saving and restoring simulation state.
+ */
+#include "rts_job_pool.h"
+#include "rts_rq.h"
+#include "rts_sched.h"
+#include "rts_sim.h"
+#include "rts_snapshot.h"
+#include "rts_types.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* On-disk sizes of the header and records (see rts_snapshot.h) */
+#define SNAP_HDR_LEN  (2 * RTS_SNAPSHOT_NAME_LEN + 5 * 4 + 7 * 8 + 8 * 8)
+#define SNAP_TASK_LEN (6 * 4 + 2 * 8)
+#define SNAP_JOB_LEN  (4 * 4 + 3 * 8)
+
+static void snap_names(struct rts_snapshot *snap, const struct rts_sim *sim,
+                       const struct rts_sched_class *sched) {
+	memset(snap->sched, 0, sizeof(snap->sched));
+	memset(snap->rq, 0, sizeof(snap->rq));
+	strncpy(snap->sched, sched->name, sizeof(snap->sched) - 1);
+	if (sim->rq_ops)
+		strncpy(snap->rq, sim->rq_ops->name, sizeof(snap->rq) - 1);
+}
+
+int rts_snapshot_take(struct rts_snapshot *snap, const struct rts_sim *sim,
+                      const struct rts_sched_class *sched, int engine) {
+	const struct rts_list_head *p;
+	int n_jobs = 0;
+
+	memset(snap, 0, sizeof(*snap));
+	snap_names(snap, sim, sched);
+	snap->engine = engine;
+	snap->clock = sim->clock;
+	snap->total_jobs = sim->total_jobs;
+	snap->missed_jobs = sim->missed_jobs;
+	snap->preemptions = sim->preemptions;
+	snap->migrations = sim->migrations;
+	snap->switch_cost = sim->switch_cost;
+	snap->switches = sim->switches;
+	snap->overhead = sim->overhead;
+	snap->stats = sim->stats;
+	snap->last = -1;
+
+	rts_list_for_each(p, &sim->ready_queue.jobs)
+		n_jobs++;
+
+	snap->tasks = malloc(sizeof(*snap->tasks) * (size_t)(sim->n_tasks > 0 ? sim->n_tasks : 1));
+	snap->jobs = malloc(sizeof(*snap->jobs) * (size_t)(n_jobs > 0 ? n_jobs : 1));
+	if (!snap->tasks || !snap->jobs) {
+		rts_snapshot_free(snap);
+		return -1;
+	}
+
+	memcpy(snap->tasks, sim->tasks, sizeof(*snap->tasks) * (size_t)sim->n_tasks);
+	snap->n_tasks = sim->n_tasks;
+
+	rts_list_for_each(p, &sim->ready_queue.jobs) {
+		const struct rts_job *job = rts_list_entry(p, struct rts_job, qnode);
+
+		if (job == sim->last)
+			snap->last = snap->n_jobs;
+		snap->jobs[snap->n_jobs++] = *job;
+	}
+
+	return 0;
+}
+
+int rts_snapshot_restore(const struct rts_snapshot *snap, struct rts_sim *sim,
+                         const struct rts_sched_class *sched) {
+	memcpy(sim->tasks, snap->tasks, sizeof(*snap->tasks) * (size_t)snap->n_tasks);
+	sim->n_tasks = snap->n_tasks;
+	sim->clock = snap->clock;
+	sim->total_jobs = snap->total_jobs;
+	sim->missed_jobs = snap->missed_jobs;
+	sim->preemptions = snap->preemptions;
+	sim->migrations = snap->migrations;
+	sim->switch_cost = snap->switch_cost;
+	sim->switches = snap->switches;
+	sim->overhead = snap->overhead;
+	sim->steady = 0;
+
+	if (rts_sim_resume(sim, sched) != 0)
+		return -1;
+
+	/*
+	 * Let the backend index every job, then put it back in its saved list
+	 * position: the list backend's order reflects when jobs arrived under
+	 * time-varying priorities, which reinserting now would not reproduce.
+	 */
+	for (int i = 0; i < snap->n_jobs; i++) {
+		struct rts_job *job = rts_job_pool_alloc(&sim->job_pool);
+
+		if (!job) {
+			rts_sim_finish(sim);
+			return -1;
+		}
+
+		*job = snap->jobs[i];
+		job->hidx = -1;
+		rts_rq_insert(&sim->ready_queue, job);
+		rts_list_del(&job->qnode);
+		rts_list_add_tail(&job->qnode, &sim->ready_queue.jobs);
+		if (i == snap->last)
+			sim->last = job;
+	}
+
+	sim->stats = snap->stats;
+	return 0;
+}
+
+void rts_snapshot_free(struct rts_snapshot *snap) {
+	free(snap->tasks);
+	free(snap->jobs);
+	snap->tasks = NULL;
+	snap->jobs = NULL;
+	snap->n_tasks = 0;
+	snap->n_jobs = 0;
+}
+
+static unsigned char *snap_put32(unsigned char *p, int32_t v) {
+	uint32_t u = (uint32_t)v;
+
+	for (int i = 0; i < 4; i++)
+		p[i] = (unsigned char)(u >> (8 * i));
+	return p + 4;
+}
+
+static unsigned char *snap_put64(unsigned char *p, uint64_t u) {
+	for (int i = 0; i < 8; i++)
+		p[i] = (unsigned char)(u >> (8 * i));
+	return p + 8;
+}
+
+static const unsigned char *snap_get32(const unsigned char *p, int32_t *v) {
+	uint32_t u = 0;
+
+	for (int i = 0; i < 4; i++)
+		u |= (uint32_t)p[i] << (8 * i);
+	*v = (int32_t)u;
+	return p + 4;
+}
+
+static const unsigned char *snap_get64(const unsigned char *p, uint64_t *u) {
+	*u = 0;
+	for (int i = 0; i < 8; i++)
+		*u |= (uint64_t)p[i] << (8 * i);
+	return p + 8;
+}
+
+/* Counters stored as long in memory; saved as int64 */
+static const unsigned char *snap_get_long(const unsigned char *p, long *v) {
+	uint64_t u;
+
+	p = snap_get64(p, &u);
+	*v = (long)(int64_t)u;
+	return p;
+}
+
+static const unsigned char *snap_get_count(const unsigned char *p, int64_t *v) {
+	uint64_t u;
+
+	p = snap_get64(p, &u);
+	*v = (int64_t)u;
+	return p;
+}
+
+static const unsigned char *snap_get_time(const unsigned char *p, rts_time_t *v) {
+	uint64_t u;
+
+	p = snap_get64(p, &u);
+	*v = (rts_time_t)u;
+	return p;
+}
+
+int rts_snapshot_write(FILE *fp, const struct rts_snapshot *snap) {
+	char magic[RTS_SNAPSHOT_MAGIC_LEN] = RTS_SNAPSHOT_MAGIC;
+	unsigned char hdr[SNAP_HDR_LEN], *p = hdr;
+	const struct rts_stats *st = &snap->stats;
+
+	fwrite(magic, 1, sizeof(magic), fp);
+
+	memcpy(p, snap->sched, RTS_SNAPSHOT_NAME_LEN);
+	p += RTS_SNAPSHOT_NAME_LEN;
+	memcpy(p, snap->rq, RTS_SNAPSHOT_NAME_LEN);
+	p += RTS_SNAPSHOT_NAME_LEN;
+	p = snap_put32(p, snap->engine);
+	p = snap_put32(p, snap->n_tasks);
+	p = snap_put32(p, snap->n_jobs);
+	p = snap_put32(p, snap->last);
+	p = snap_put32(p, snap->switch_cost);
+	p = snap_put64(p, (uint64_t)snap->clock);
+	p = snap_put64(p, (uint64_t)snap->total_jobs);
+	p = snap_put64(p, (uint64_t)snap->missed_jobs);
+	p = snap_put64(p, (uint64_t)snap->preemptions);
+	p = snap_put64(p, (uint64_t)snap->migrations);
+	p = snap_put64(p, (uint64_t)snap->switches);
+	p = snap_put64(p, (uint64_t)snap->overhead);
+	p = snap_put64(p, st->prio_cmps);
+	p = snap_put64(p, st->insert_cmps);
+	p = snap_put64(p, (uint64_t)st->rq_len);
+	p = snap_put64(p, (uint64_t)st->rq_len_max);
+	p = snap_put64(p, st->rq_len_sum);
+	p = snap_put64(p, st->time);
+	p = snap_put64(p, st->job_allocs);
+	snap_put64(p, st->idle);
+	fwrite(hdr, 1, sizeof(hdr), fp);
+
+	for (int i = 0; i < snap->n_tasks; i++) {
+		const struct rts_task *t = &snap->tasks[i];
+		unsigned char rec[SNAP_TASK_LEN];
+
+		p = snap_put32(rec, t->phase);
+		p = snap_put32(p, t->period);
+		p = snap_put32(p, t->rel_deadline);
+		p = snap_put32(p, t->wcet);
+		p = snap_put32(p, t->preemptions);
+		p = snap_put32(p, t->migrations);
+		p = snap_put64(p, (uint64_t)t->release_count);
+		snap_put64(p, (uint64_t)t->next_release);
+		fwrite(rec, 1, sizeof(rec), fp);
+	}
+
+	for (int i = 0; i < snap->n_jobs; i++) {
+		const struct rts_job *job = &snap->jobs[i];
+		unsigned char rec[SNAP_JOB_LEN];
+
+		p = snap_put32(rec, job->tid);
+		p = snap_put32(p, job->jid);
+		p = snap_put32(p, job->remain);
+		p = snap_put32(p, job->cpu);
+		p = snap_put64(p, (uint64_t)job->release_time);
+		p = snap_put64(p, (uint64_t)job->abs_deadline);
+		snap_put64(p, (uint64_t)job->start);
+		fwrite(rec, 1, sizeof(rec), fp);
+	}
+
+	return ferror(fp) ? -1 : 0;
+}
+
+/**
+ * snap_check - reject states rts_snapshot_restore() could not resume
+ */
+static int snap_check(const struct rts_snapshot *snap) {
+	if (snap->n_tasks < 0 || snap->n_jobs < 0 ||
+	    snap->last < -1 || snap->last >= snap->n_jobs)
+		return -1;
+
+	for (int i = 0; i < snap->n_tasks; i++) {
+		if (snap->tasks[i].period <= 0 || snap->tasks[i].wcet <= 0)
+			return -1;
+	}
+
+	for (int i = 0; i < snap->n_jobs; i++) {
+		const struct rts_job *job = &snap->jobs[i];
+
+		if (job->tid < 0 || job->tid >= snap->n_tasks || job->remain <= 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+int rts_snapshot_read(FILE *fp, struct rts_snapshot *snap) {
+	char magic[RTS_SNAPSHOT_MAGIC_LEN];
+	unsigned char hdr[SNAP_HDR_LEN];
+	const unsigned char *p = hdr;
+	struct rts_stats *st = &snap->stats;
+	int32_t v[5];
+
+	memset(snap, 0, sizeof(*snap));
+
+	if (fread(magic, 1, sizeof(magic), fp) != sizeof(magic) ||
+	    memcmp(magic, RTS_SNAPSHOT_MAGIC, sizeof(magic)) != 0 ||
+	    fread(hdr, 1, sizeof(hdr), fp) != sizeof(hdr))
+		goto malformed;
+
+	memcpy(snap->sched, p, RTS_SNAPSHOT_NAME_LEN);
+	p += RTS_SNAPSHOT_NAME_LEN;
+	memcpy(snap->rq, p, RTS_SNAPSHOT_NAME_LEN);
+	p += RTS_SNAPSHOT_NAME_LEN;
+	snap->sched[RTS_SNAPSHOT_NAME_LEN - 1] = '\0';
+	snap->rq[RTS_SNAPSHOT_NAME_LEN - 1] = '\0';
+
+	for (int i = 0; i < 5; i++)
+		p = snap_get32(p, &v[i]);
+	snap->engine = v[0];
+	snap->last = v[3];
+	snap->switch_cost = v[4];
+	if (v[1] < 0 || v[2] < 0 || v[4] < 0)
+		goto malformed;
+
+	p = snap_get_time(p, &snap->clock);
+	p = snap_get_count(p, &snap->total_jobs);
+	p = snap_get_count(p, &snap->missed_jobs);
+	p = snap_get_long(p, &snap->preemptions);
+	p = snap_get_long(p, &snap->migrations);
+	p = snap_get_long(p, &snap->switches);
+	p = snap_get_time(p, &snap->overhead);
+	p = snap_get64(p, &st->prio_cmps);
+	p = snap_get64(p, &st->insert_cmps);
+	p = snap_get_long(p, &st->rq_len);
+	p = snap_get_long(p, &st->rq_len_max);
+	p = snap_get64(p, &st->rq_len_sum);
+	p = snap_get64(p, &st->time);
+	p = snap_get64(p, &st->job_allocs);
+	snap_get64(p, &st->idle);
+
+	snap->tasks = malloc(sizeof(*snap->tasks) * (size_t)(v[1] > 0 ? v[1] : 1));
+	snap->jobs = malloc(sizeof(*snap->jobs) * (size_t)(v[2] > 0 ? v[2] : 1));
+	if (!snap->tasks || !snap->jobs) {
+		rts_snapshot_free(snap);
+		return -1;
+	}
+
+	for (int i = 0; i < v[1]; i++) {
+		struct rts_task *t = &snap->tasks[i];
+		unsigned char rec[SNAP_TASK_LEN];
+		int32_t f[6];
+
+		if (fread(rec, 1, sizeof(rec), fp) != sizeof(rec))
+			goto malformed;
+
+		p = rec;
+		for (int k = 0; k < 6; k++)
+			p = snap_get32(p, &f[k]);
+		memset(t, 0, sizeof(*t));
+		t->tid = i;
+		t->phase = f[0];
+		t->period = f[1];
+		t->rel_deadline = f[2];
+		t->wcet = f[3];
+		t->preemptions = f[4];
+		t->migrations = f[5];
+		t->util = t->period > 0 ? (double)t->wcet / t->period : 0;
+		p = snap_get_count(p, &t->release_count);
+		snap_get_time(p, &t->next_release);
+		snap->n_tasks++;
+	}
+
+	for (int i = 0; i < v[2]; i++) {
+		struct rts_job *job = &snap->jobs[i];
+		unsigned char rec[SNAP_JOB_LEN];
+		int32_t f[4];
+
+		if (fread(rec, 1, sizeof(rec), fp) != sizeof(rec))
+			goto malformed;
+
+		p = rec;
+		for (int k = 0; k < 4; k++)
+			p = snap_get32(p, &f[k]);
+		memset(job, 0, sizeof(*job));
+		job->tid = f[0];
+		job->jid = f[1];
+		job->remain = f[2];
+		job->cpu = f[3];
+		job->hidx = -1;
+		p = snap_get_time(p, &job->release_time);
+		p = snap_get_time(p, &job->abs_deadline);
+		snap_get_time(p, &job->start);
+		snap->n_jobs++;
+	}
+
+	if (snap_check(snap) == 0)
+		return 0;
+
+malformed:
+	fprintf(stderr, "Error: malformed snapshot\n");
+	rts_snapshot_free(snap);
+	return -1;
+}
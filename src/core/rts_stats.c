@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_stats.c
+ * @brief JSON run report.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "rts_stats.h"
+#include "rts_hist.h"
+#include "rts_rq.h"
+#include "rts_sched.h"
+#include "rts_trace.h"
+#include "rts_types.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+static void stats_json_string(FILE *out, const char *s) {
+	if (!s) {
+		fputs("null", out);
+		return;
+	}
+
+	fputc('"', out);
+	for (; *s; s++) {
+		unsigned char c = (unsigned char)*s;
+
+		if (c == '"' || c == '\\')
+			fprintf(out, "\\%c", c);
+		else if (c < 0x20)
+			fprintf(out, "\\u%04x", c);
+		else
+			fputc(c, out);
+	}
+	fputc('"', out);
+}
+
+static void stats_json_hist(FILE *out, const char *key, const struct rts_hist *h) {
+	if (!h->count) {
+		fprintf(out, ",\"%s\":null", key);
+		return;
+	}
+
+	fprintf(out, ",\"%s\":{\"min\":%" PRId64 ",\"mean\":%.4f,\"p99\":%" PRId64
+	             ",\"max\":%" PRId64 "}",
+	        key, h->min, rts_hist_mean(h), rts_hist_percentile(h, 99.0), h->max);
+}
+
+/* Per-task timing, in the order of the simulated task set */
+static void stats_json_tasks(FILE *out, const struct rts_sim *sim) {
+	fputs(",\"task_stats\":[", out);
+	for (int i = 0; i < sim->n_tasks; i++) {
+		const struct rts_task_stats *ts = &sim->task_stats[i];
+
+		fprintf(out, "%s{\"completed\":%" PRIu64, i ? "," : "", ts->response.count);
+		stats_json_hist(out, "response", &ts->response);
+		stats_json_hist(out, "lateness", &ts->lateness);
+		stats_json_hist(out, "start", &ts->start);
+		fprintf(out, ",\"start_jitter\":%" PRId64 ",\"response_jitter\":%" PRId64 "}",
+		        ts->start.count ? ts->start.max - ts->start.min : 0,
+		        ts->response.count ? ts->response.max - ts->response.min : 0);
+	}
+	fputc(']', out);
+}
+
+void rts_stats_report(FILE *out, const struct rts_sim *sim,
+                      const struct rts_sched_class *sched, int n_cpus) {
+	double util = 0.0;
+	uint64_t trace_bytes = 0;
+
+	for (int i = 0; i < sim->n_tasks; i++)
+		util += sim->tasks[i].util;
+	for (int c = 0; sim->trace && c < n_cpus; c++)
+		trace_bytes += sim->trace[c].bytes;
+
+	flockfile(out);
+
+	fputs("{\"name\":", out);
+	stats_json_string(out, sim->name);
+	fputs(",\"sched\":", out);
+	stats_json_string(out, sched->name);
+	fputs(",\"rq\":", out);
+	stats_json_string(out, sim->ready_queue.ops ? sim->ready_queue.ops->name : NULL);
+	fprintf(out, ",\"cpus\":%d,\"tasks\":%d,\"utilization\":%.6f"
+	             ",\"horizon\":%" PRId64 ",\"total_jobs\":%" PRId64 ",\"missed_jobs\":%" PRId64
+	             ",\"preemptions\":%ld,\"migrations\":%ld,\"switches\":%ld"
+	             ",\"switch_cost\":%d,\"overhead\":%" PRId64 ",\"trace_bytes\":%" PRIu64,
+	        n_cpus, sim->n_tasks, util, sim->clock, sim->total_jobs, sim->missed_jobs,
+	        sim->preemptions, sim->migrations, sim->switches,
+	        sim->switch_cost, sim->overhead, trace_bytes);
+	if (sim->task_stats)
+		stats_json_tasks(out, sim);
+
+#ifdef RTS_STATS
+	const struct rts_stats *s = &sim->stats;
+
+	fprintf(out, ",\"counters\":{\"higher_prio_calls\":%" PRIu64
+	             ",\"insert_cmps\":%" PRIu64 ",\"rq_len_max\":%ld"
+	             ",\"rq_len_mean\":%.4f,\"job_allocs\":%" PRIu64
+	             ",\"idle_ticks\":%" PRIu64 "}}\n",
+	        s->prio_cmps, s->insert_cmps, s->rq_len_max,
+	        s->time ? (double)s->rq_len_sum / (double)s->time : 0.0,
+	        s->job_allocs, s->idle);
+#else
+	fputs(",\"counters\":null}\n", out);
+#endif
+
+	funlockfile(out);
+}
@@ -3,41 +3,157 @@
  * @file main.c
  * @brief Entry point for RTOS scheduling simulator (rtsim).
  */
+#include "rts_batch.h"
+#include "rts_gen.h"
+#include "rts_hist.h"
 #include "rts_list.h"
+#include "rts_log.h"
 #include "rts_parser.h"
+#include "rts_partition.h"
+#include "rts_rq.h"
 #include "rts_sched.h"
+#include "rts_sens.h"
+#include "rts_sim.h"
 #include "rts_trace.h"
 #include "rts_types.h"
 #include "rts_util.h"
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-void rts_rq_init(struct rts_list_head *head);
+static void usage(const char *prog) {
+	fprintf(stderr, "Usage: %s [--engine=tick|event] [--rq=list|heap]\n"
+	                "       %*s [--trace-format=tick|interval|binary] [--no-trace]\n"
+	                "       %*s [--verbosity=summary|events|full] [--sync-log]\n"
+	                "       %*s [--steady] [--analyze] [--stats=FILE] [--task-stats]\n"
+	                "       %*s [--switch-cost=N] <SCHED> <task.txt>\n",
+	        prog, (int)strlen(prog), "", (int)strlen(prog), "", (int)strlen(prog), "",
+	        (int)strlen(prog), "");
+	fprintf(stderr, "       %s --batch [--jobs=N] [--policies=RM,EDF,...] [--manifest=FILE]\n"
+	                "       %*s [--no-trace] [options] [task.txt|glob...]\n",
+	        prog, (int)strlen(prog), "");
+	fprintf(stderr, "       %s --cores=M [--partition=ffd|wfd|bfd|--global] [options] <SCHED> <task.txt>\n", prog);
+	fprintf(stderr, "       %s --lockstep [--policies=RM,EDF,...] [options] <task.txt>\n", prog);
+	fprintf(stderr, "       %s --sensitivity[=TASK] [--policies=RM,EDF,...] [--rq=...]\n"
+	                "       %*s [--switch-cost=N] <task.txt>\n",
+	        prog, (int)strlen(prog), "");
+	fprintf(stderr, "       %s --gen=n=N,u=U,... [out.txt]\n", prog);
+	fprintf(stderr, "       %s --trace-to-ticks <trace.itv|trace.bin> [out.txt]\n", prog);
+	fprintf(stderr, "       %s --tasks-to-binary <task.txt> [out.tsb]\n", prog);
+	fprintf(stderr, "Example: %s EDF task.txt\n", prog);
+}
+
+/**
+ * parse_policies - resolve a comma-separated scheduler list
+ * @list: e.g. "RM,EDF"; NULL selects every registered scheduler
+ * @n_out: number of schedulers returned
+ *
+ * Returns a malloc'd array, or NULL on error.
+ */
+static const struct rts_sched_class **parse_policies(const char *list, int *n_out) {
+	const struct rts_sched_class * const *all = rts_sched_list();
+	int cap = 0;
+
+	while (all[cap])
+		cap++;
+	if (list) {
+		for (const char *c = list; *c; c++)
+			cap += (*c == ',');
+	}
+
+	const struct rts_sched_class **scheds = malloc(sizeof(*scheds) * (cap + 1));
+	if (!scheds)
+		return NULL;
+
+	int n = 0;
+	if (!list) {
+		for (; all[n]; n++)
+			scheds[n] = all[n];
+	} else {
+		const char *p = list;
+
+		for (;;) {
+			char name[64];
+			size_t len = strcspn(p, ",");
 
-void rts_sim_run(struct rts_sim *sim,
-                 const struct rts_sched_class *sched,
-                 int lcm, int max_phase);
+			snprintf(name, sizeof(name), "%.*s", (int)len, p);
+			const struct rts_sched_class *sched = rts_sched_from_name(name);
+			if (!sched) {
+				free(scheds);
+				return NULL;
+			}
+			scheds[n++] = sched;
+
+			if (p[len] == '\0')
+				break;
+			p += len + 1;
+		}
+	}
+
+	*n_out = n;
+	return scheds;
+}
 
 /**
- * main - entry point
- * @argc: argument count
- * @argv: [1] scheduler name, [2] task file
+ * task_stats_alloc - per-task histograms for @n_tasks @tasks, if @on
  *
- * Example:
- *     ./rtsim EDF task.txt
+ * Returns NULL when off; exits if they cannot be allocated.
  */
-int main(int argc, char *argv[]) {
-	if (argc < 3) {
-		fprintf(stderr, "Usage: %s <SCHED> <task.txt>\n", argv[0]);
-		fprintf(stderr, "Example: %s EDF task.txt\n", argv[0]);
+static struct rts_task_stats *task_stats_alloc(int on, const struct rts_task *tasks,
+                                               int n_tasks) {
+	if (!on)
+		return NULL;
+
+	struct rts_task_stats *ts = rts_task_stats_alloc(tasks, n_tasks);
+	if (!ts) {
+		fprintf(stderr, "Error: cannot allocate task statistics\n");
+		exit(EXIT_FAILURE);
+	}
+	return ts;
+}
+
+/**
+ * run_batch - simulate many task files under several policies
+ */
+static int run_batch(struct rts_batch_opts *opts, const char *policies,
+                     const char *manifest, char **args, int n_args) {
+	int status = 1;
+
+	opts->scheds = parse_policies(policies, &opts->n_scheds);
+	if (!opts->scheds)
 		return 1;
+
+	if (manifest && rts_batch_add_manifest(&opts->paths, &opts->n_paths, manifest) != 0)
+		goto out;
+
+	for (int i = 0; i < n_args; i++) {
+		if (rts_batch_add_paths(&opts->paths, &opts->n_paths, args[i]) != 0)
+			goto out;
 	}
 
-	const char *sched_name = argv[1];
-	const char *task_file = argv[2];
+	if (opts->n_paths == 0) {
+		fprintf(stderr, "Error: no task files given\n");
+		goto out;
+	}
 
+	status = rts_batch_run(opts, stdout);
+
+out:
+	rts_batch_free_paths(opts->paths, opts->n_paths);
+	free(opts->scheds);
+	return status;
+}
+
+/**
+ * run_lockstep - simulate every selected policy on one task file in a
+ * single pass over the time axis
+ */
+static int run_lockstep(const char *task_file, const char *policies,
+                        const struct rts_rq_ops *rq_ops, int engine,
+                        int trace_on, int trace_fmt, FILE *report, int task_stats,
+                        int switch_cost) {
 	int n_tasks = 0;
 	struct rts_task *tasks = rts_parser_load_tasks(task_file, &n_tasks);
 	if (!tasks) {
@@ -45,38 +161,544 @@ int main(int argc, char *argv[]) {
 		return 1;
 	}
 
-	/* Compute hyperperiod and max phase */
-	int *periods = malloc(sizeof(int) * n_tasks);
-	int max_phase = 0;
+	rts_time_t lcm, max_phase;
+	if (rts_sim_horizon(tasks, n_tasks, &lcm, &max_phase, 0) != 0) {
+		fprintf(stderr, "Error: hyperperiod of %s exceeds the 64-bit time range\n", task_file);
+		free(tasks);
+		return 1;
+	}
+
+	printf("Loaded %d tasks. LCM=%" PRId64 ", MaxPhase=%" PRId64 "\n", n_tasks, lcm, max_phase);
+
+	int n = 0;
+	const struct rts_sched_class **scheds = parse_policies(policies, &n);
+	struct rts_sim *sims = calloc((size_t)(n > 0 ? n : 1), sizeof(*sims));
+	struct rts_trace *traces = calloc((size_t)(n > 0 ? n : 1), sizeof(*traces));
+	if (!scheds || !sims || !traces) {
+		free(traces);
+		free(sims);
+		free(scheds);
+		free(tasks);
+		return 1;
+	}
+
+	for (int k = 0; k < n; k++) {
+		if (scheds[k]->schedulability_test &&
+		    !scheds[k]->schedulability_test(tasks, n_tasks, stdout))
+			printf("[Warn] Task set may miss deadlines under %s policy.\n", scheds[k]->name);
+
+		char outpath[512];
+		FILE *trace = NULL;
+		if (trace_on) {
+			trace = rts_trace_open_fmt("output", task_file, scheds[k]->name,
+			                           trace_fmt, outpath, sizeof(outpath));
+			if (trace)
+				printf("[trace] writing to %s\n", outpath);
+		}
+		rts_trace_init(&traces[k], trace, trace_fmt);
+
+		sims[k].tasks = tasks;
+		sims[k].n_tasks = n_tasks;
+		sims[k].trace = trace ? &traces[k] : NULL;
+		sims[k].rq_ops = rq_ops;
+		sims[k].report = report;
+		sims[k].name = task_file;
+		sims[k].task_stats = task_stats_alloc(task_stats, tasks, n_tasks);
+		sims[k].switch_cost = switch_cost;
+	}
+	printf("\n");
+
+	rts_sim_run_lockstep(sims, scheds, n, engine, lcm, max_phase);
+
+	for (int k = 0; k < n; k++) {
+		printf("%s: Simulation complete. Misses=%" PRId64 ", Jobs=%" PRId64 ", Preemptions=%ld, Switches=%ld, Overhead=%" PRId64 "\n",
+		       scheds[k]->name, sims[k].missed_jobs, sims[k].total_jobs,
+		       sims[k].preemptions, sims[k].switches, sims[k].overhead);
+		if (sims[k].task_stats)
+			rts_task_stats_print(sims[k].task_stats, n_tasks, stdout);
+
+		rts_trace_close(&traces[k]);
+		free(sims[k].task_stats);
+	}
+
+	free(traces);
+	free(sims);
+	free(scheds);
+	free(tasks);
+	return 0;
+}
+
+/**
+ * print_overheads - per-task preemptions and migrations of the last run
+ */
+static void print_overheads(const struct rts_task *tasks, int n_tasks) {
 	for (int i = 0; i < n_tasks; i++) {
-		periods[i] = tasks[i].period;
+		const struct rts_task *t = &tasks[i];
+		int64_t jobs = t->release_count > 0 ? t->release_count : 1;
+
+		printf("  T%d: jobs=%" PRId64 " preemptions=%d (%.2f/job) migrations=%d (%.2f/job)\n",
+		       t->tid + 1, t->release_count,
+		       t->preemptions, (double)t->preemptions / jobs,
+		       t->migrations, (double)t->migrations / jobs);
+	}
+}
+
+/**
+ * run_partitioned - bin-pack the task set onto @n_cores cores and simulate
+ * each core on its own host thread
+ */
+static int run_partitioned(const char *sched_name, const char *task_file,
+                           int n_cores, int fit,
+                           const struct rts_partition_opts *popts, int trace_fmt,
+                           int task_stats) {
+	const struct rts_sched_class *sched = rts_sched_from_name(sched_name);
+	if (!sched)
+		return 1;
+
+	if (popts->trace && trace_fmt == RTS_TRACE_BINARY) {
+		fprintf(stderr, "Error: binary traces are not supported with --cores\n");
+		return 1;
+	}
+
+	int n_tasks = 0;
+	struct rts_task *tasks = rts_parser_load_tasks(task_file, &n_tasks);
+	if (!tasks) {
+		fprintf(stderr, "Failed to load %s\n", task_file);
+		return 1;
+	}
 
-		if (tasks[i].phase > max_phase)
-			max_phase = tasks[i].phase;
+	rts_time_t lcm, max_phase;
+	if (rts_sim_horizon(tasks, n_tasks, &lcm, &max_phase, popts->steady) != 0) {
+		fprintf(stderr, "Error: hyperperiod of %s exceeds the 64-bit time range\n", task_file);
+		free(tasks);
+		return 1;
+	}
+
+	printf("Loaded %d tasks. LCM=%" PRId64 ", MaxPhase=%" PRId64 "\n", n_tasks, lcm, max_phase);
+
+	struct rts_partition part;
+	if (rts_partition_assign(&part, tasks, n_tasks, n_cores, fit, sched) != 0) {
+		fprintf(stderr, "Error: cannot partition %s\n", task_file);
+		free(tasks);
+		return 1;
 	}
-	int lcm = rts_util_hyperperiod(periods, n_tasks);
-	free(periods);
 
-	printf("Loaded %d tasks. LCM=%d, MaxPhase=%d\n", n_tasks, lcm, max_phase);
+	printf("[partition] %s on %d cores:\n", sched->name, n_cores);
+	rts_partition_print(&part, stdout);
+	if (part.n_forced)
+		printf("[Warn] %d task(s) fit no core under %s; placed on the least loaded one.\n",
+		       part.n_forced, sched->name);
+	printf("\n");
+
+	struct rts_partition_opts opts = *popts;
+	opts.task_stats = task_stats_alloc(task_stats, tasks, n_tasks);
+
+	rts_partition_run(&part, sched, &opts, lcm, max_phase);
+
+	int64_t misses = 0, jobs = 0;
+	long preemptions = 0, switches = 0;
+	rts_time_t overhead = 0;
+	for (int c = 0; c < part.n_cores; c++) {
+		const struct rts_partition_core *core = &part.cores[c];
+
+		printf("CPU%d: Misses=%" PRId64 ", Jobs=%" PRId64 ", Preemptions=%ld, Switches=%ld, %.3f ms\n",
+		       c, core->missed_jobs, core->total_jobs, core->preemptions,
+		       core->switches, core->ms);
+		if (core->cycle_len)
+			printf("CPU%d: Steady state from t=%" PRId64 ", repeating every %" PRId64 "\n",
+			       c, core->cycle_start, core->cycle_len);
+		misses += core->missed_jobs;
+		jobs += core->total_jobs;
+		preemptions += core->preemptions;
+		switches += core->switches;
+		overhead += core->overhead;
+	}
+	printf("Simulation complete. Misses=%" PRId64 ", Jobs=%" PRId64 "\n", misses, jobs);
+	printf("Preemptions=%ld, Migrations=0, Switches=%ld, Overhead=%" PRId64 "\n",
+	       preemptions, switches, overhead);
 
+	rts_partition_collect(&part, tasks);
+	print_overheads(tasks, n_tasks);
+	if (opts.task_stats)
+		rts_task_stats_print(opts.task_stats, n_tasks, stdout);
+	free(opts.task_stats);
+	free(tasks);
+
+	if (popts->trace) {
+		char tag[64], outpath[512];
+
+		snprintf(tag, sizeof(tag), "%s_%dcpu", sched->name, n_cores);
+		FILE *fp = rts_trace_open_fmt("output", task_file, tag, trace_fmt,
+		                              outpath, sizeof(outpath));
+		if (fp) {
+			if (rts_partition_merge_trace(&part, fp, trace_fmt) != 0)
+				fprintf(stderr, "Error: cannot merge per-core traces\n");
+			else
+				printf("[trace] merged into %s\n", outpath);
+			fclose(fp);
+		}
+	}
+
+	rts_partition_destroy(&part);
+	return 0;
+}
+
+/**
+ * run_global - schedule the task set on @n_cpus CPUs from one shared
+ * ready queue
+ */
+static int run_global(const char *sched_name, const char *task_file,
+                      int n_cpus, const struct rts_rq_ops *rq_ops, int engine,
+                      int trace_on, int trace_fmt, int log_level, int log_async,
+                      FILE *report, int task_stats, int switch_cost) {
 	const struct rts_sched_class *sched = rts_sched_from_name(sched_name);
 	if (!sched)
 		return 1;
 
+	if (sched->preempt_at) {
+		fprintf(stderr, "Error: %s priorities change over time; global mode needs fixed job priorities\n",
+		        sched->name);
+		return 1;
+	}
+
+	if (trace_on && trace_fmt == RTS_TRACE_BINARY) {
+		fprintf(stderr, "Error: binary traces are not supported with --cores\n");
+		return 1;
+	}
+
+	int n_tasks = 0;
+	struct rts_task *tasks = rts_parser_load_tasks(task_file, &n_tasks);
+	if (!tasks) {
+		fprintf(stderr, "Failed to load %s\n", task_file);
+		return 1;
+	}
+
+	rts_time_t lcm, max_phase;
+	if (rts_sim_horizon(tasks, n_tasks, &lcm, &max_phase, 0) != 0) {
+		fprintf(stderr, "Error: hyperperiod of %s exceeds the 64-bit time range\n", task_file);
+		free(tasks);
+		return 1;
+	}
+
+	printf("Loaded %d tasks. LCM=%" PRId64 ", MaxPhase=%" PRId64 "\n", n_tasks, lcm, max_phase);
+	printf("[global] G-%s on %d CPUs\n\n", sched->name, n_cpus);
+
+	/* Per-CPU interval traces, merged once the run is over */
+	struct rts_trace *traces = calloc((size_t)n_cpus, sizeof(*traces));
+	FILE **trace_fp = calloc((size_t)n_cpus, sizeof(*trace_fp));
+	if (!traces || !trace_fp) {
+		free(trace_fp);
+		free(traces);
+		free(tasks);
+		return 1;
+	}
+
+	for (int c = 0; trace_on && c < n_cpus; c++) {
+		trace_fp[c] = tmpfile();
+		if (!trace_fp[c]) {
+			perror("tmpfile");
+			trace_on = 0;
+		}
+	}
+	for (int c = 0; c < n_cpus; c++)
+		rts_trace_init(&traces[c], trace_on ? trace_fp[c] : NULL, RTS_TRACE_INTERVAL);
+
+	struct rts_log log;
+	struct rts_sim sim = {
+	    .tasks = tasks,
+	    .n_tasks = n_tasks,
+	    .trace = trace_on ? traces : NULL,
+	    .rq_ops = rq_ops,
+	    .log = &log,
+	    .report = report,
+	    .name = task_file,
+	    .task_stats = task_stats_alloc(task_stats, tasks, n_tasks),
+	    .switch_cost = switch_cost,
+	};
+
+	rts_log_open(&log, stdout, log_level, log_async);
+	rts_sim_run_global(&sim, sched, n_cpus, engine, lcm, max_phase);
+	rts_log_close(&log);
+	sim.log = NULL;
+
+	printf("Simulation complete. Misses=%" PRId64 ", Jobs=%" PRId64 "\n",
+	       sim.missed_jobs, sim.total_jobs);
+	printf("Preemptions=%ld, Migrations=%ld, Switches=%ld, Overhead=%" PRId64 "\n",
+	       sim.preemptions, sim.migrations, sim.switches, sim.overhead);
+	print_overheads(tasks, n_tasks);
+	if (sim.task_stats)
+		rts_task_stats_print(sim.task_stats, n_tasks, stdout);
+	free(sim.task_stats);
+
+	if (trace_on) {
+		char tag[64], outpath[512];
+
+		snprintf(tag, sizeof(tag), "G-%s_%dcpu", sched->name, n_cpus);
+		FILE *fp = rts_trace_open_fmt("output", task_file, tag, trace_fmt,
+		                              outpath, sizeof(outpath));
+		if (fp) {
+			if (rts_trace_merge(trace_fp, NULL, n_cpus, fp, trace_fmt) != 0)
+				fprintf(stderr, "Error: cannot merge per-CPU traces\n");
+			else
+				printf("[trace] merged into %s\n", outpath);
+			fclose(fp);
+		}
+	}
+
+	for (int c = 0; c < n_cpus; c++)
+		rts_trace_close(&traces[c]);
+	free(trace_fp);
+	free(traces);
+	free(tasks);
+	return 0;
+}
+
+/**
+ * run_analysis - settle schedulability analytically instead of simulating
+ *
+ * Returns 0 if the task set is schedulable, 2 if not, 1 on error.
+ */
+static int run_analysis(const char *sched_name, const char *task_file) {
+	const struct rts_sched_class *sched = rts_sched_from_name(sched_name);
+	if (!sched)
+		return 1;
+
+	if (!sched->analyze) {
+		fprintf(stderr, "Error: no exact analysis for %s; simulate instead\n", sched->name);
+		return 1;
+	}
+
+	int n_tasks = 0;
+	struct rts_task *tasks = rts_parser_load_tasks(task_file, &n_tasks);
+	if (!tasks) {
+		fprintf(stderr, "Failed to load %s\n", task_file);
+		return 1;
+	}
+
+	printf("Loaded %d tasks.\n", n_tasks);
+	int ok = sched->analyze(tasks, n_tasks, stdout);
+
+	free(tasks);
+	return ok ? 0 : 2;
+}
+
+/**
+ * run_sensitivity - critical WCET scaling factor of one task file under
+ * every selected policy
+ * @target: task index to scale, or RTS_SENS_ALL
+ */
+static int run_sensitivity(const char *task_file, const char *policies,
+                           const struct rts_rq_ops *rq_ops, int target,
+                           int switch_cost) {
+	int n_tasks = 0;
+	struct rts_task *tasks = rts_parser_load_tasks(task_file, &n_tasks);
+	if (!tasks) {
+		fprintf(stderr, "Failed to load %s\n", task_file);
+		return 1;
+	}
+
+	struct rts_sens sens;
+	if (rts_sens_init(&sens, tasks, n_tasks, target, rq_ops) != 0) {
+		fprintf(stderr, "Error: cannot scale T%d of %s\n", target + 1, task_file);
+		free(tasks);
+		return 1;
+	}
+	sens.switch_cost = switch_cost;
+
+	int n = 0;
+	const struct rts_sched_class **scheds = parse_policies(policies, &n);
+	if (!scheds) {
+		rts_sens_destroy(&sens);
+		free(tasks);
+		return 1;
+	}
+
+	double util = 0.0;
+	for (int i = 0; i < n_tasks; i++)
+		util += tasks[i].util;
+
+	printf("Loaded %d tasks. U=%.4f\n", n_tasks, util);
+	if (target == RTS_SENS_ALL)
+		printf("[sensitivity] scaling every WCET\n");
+	else
+		printf("[sensitivity] scaling the WCET of T%d\n", target + 1);
+
+	int status = 0;
+	for (int k = 0; k < n; k++) {
+		struct rts_sens_result res;
+
+		if (rts_sens_search(&sens, scheds[k], &res) != 0) {
+			fprintf(stderr, "Error: hyperperiod of %s exceeds the 64-bit time range\n",
+			        task_file);
+			status = 1;
+			continue;
+		}
+
+		printf("%s: factor=%.4f breakdown U=%.4f (%d %s probes, limit %.4f)\n",
+		       scheds[k]->name, res.factor, res.util, res.probes,
+		       res.analytic ? "analytic" : "simulated", res.limit);
+	}
+
+	free(scheds);
+	rts_sens_destroy(&sens);
+	free(tasks);
+	return status;
+}
+
+/**
+ * run_gen - write a synthetic task set
+ * @spec:     generator parameters (see rts_gen_parse())
+ * @out_path: task file to write (NULL: stdout)
+ */
+static int run_gen(const char *spec, const char *out_path) {
+	struct rts_gen_opts opts;
+
+	rts_gen_defaults(&opts);
+	if (rts_gen_parse(&opts, spec) != 0)
+		return 1;
+
+	int n_tasks = 0;
+	struct rts_task *tasks = rts_gen_tasks(&opts, &n_tasks);
+	if (!tasks)
+		return 1;
+
+	/* WCETs are whole time units, so small utilizations round up */
+	double util = 0.0;
+	for (int i = 0; i < n_tasks; i++)
+		util += tasks[i].util;
+	fprintf(stderr, "[gen] %d tasks, U=%.4f (requested %.4f)\n", n_tasks, util, opts.util);
+
+	FILE *out = out_path ? fopen(out_path, "w") : stdout;
+	if (!out) {
+		perror("open output file");
+		free(tasks);
+		return 1;
+	}
+
+	int ret = rts_gen_write(out, tasks, n_tasks);
+	if (out != stdout)
+		ret |= fclose(out);
+	if (ret != 0)
+		fprintf(stderr, "Error: cannot write the task set\n");
+
+	free(tasks);
+	return ret != 0;
+}
+
+/**
+ * trace_to_ticks - convert an interval or binary trace back to tick text
+ * @in_path:  trace file
+ * @out_path: output file (NULL: stdout)
+ */
+static int trace_to_ticks(const char *in_path, const char *out_path) {
+	FILE *in = fopen(in_path, "rb");
+	if (!in) {
+		perror("open trace file");
+		return 1;
+	}
+
+	FILE *out = out_path ? fopen(out_path, "w") : stdout;
+	if (!out) {
+		perror("open output file");
+		fclose(in);
+		return 1;
+	}
+
+	int ret = rts_trace_to_ticks(in, out);
+	if (ret != 0)
+		fprintf(stderr, "Error: malformed trace %s\n", in_path);
+
+	fclose(in);
+	if (out != stdout)
+		fclose(out);
+	return ret != 0;
+}
+
+/**
+ * tasks_to_binary - convert a task set to the binary task set format
+ * @in_path:  task file (text or binary)
+ * @out_path: output file (NULL: stdout)
+ */
+static int tasks_to_binary(const char *in_path, const char *out_path) {
+	int n_tasks = 0;
+	struct rts_task *tasks = rts_parser_load_tasks(in_path, &n_tasks);
+	if (!tasks) {
+		fprintf(stderr, "Failed to load %s\n", in_path);
+		return 1;
+	}
+
+	FILE *out = out_path ? fopen(out_path, "wb") : stdout;
+	if (!out) {
+		perror("open output file");
+		free(tasks);
+		return 1;
+	}
+
+	int ret = rts_parser_write_binary(out, tasks, n_tasks);
+	if (out != stdout)
+		ret |= fclose(out);
+	else
+		ret |= fflush(out);
+	if (ret != 0)
+		fprintf(stderr, "Error: cannot write the task set\n");
+
+	free(tasks);
+	return ret != 0;
+}
+
+/**
+ * run_single - simulate one task file under one policy on one processor
+ */
+static int run_single(const char *sched_name, const char *task_file,
+                      const struct rts_rq_ops *rq_ops, int engine,
+                      int trace_on, int trace_fmt, int steady, int log_level, int log_async, FILE *report,
+                      int task_stats, int switch_cost) {
+	int n_tasks = 0;
+	struct rts_task *tasks = rts_parser_load_tasks(task_file, &n_tasks);
+	if (!tasks) {
+		fprintf(stderr, "Failed to load %s\n", task_file);
+		return 1;
+	}
+
+	/* Compute hyperperiod and max phase */
+	rts_time_t lcm, max_phase;
+	if (rts_sim_horizon(tasks, n_tasks, &lcm, &max_phase, steady) != 0) {
+		fprintf(stderr, "Error: hyperperiod of %s exceeds the 64-bit time range\n", task_file);
+		free(tasks);
+		return 1;
+	}
+
+	printf("Loaded %d tasks. LCM=%" PRId64 ", MaxPhase=%" PRId64 "\n", n_tasks, lcm, max_phase);
+
+	const struct rts_sched_class *sched = rts_sched_from_name(sched_name);
+	if (!sched) {
+		free(tasks);
+		return 1;
+	}
+
+
 	/* Schedulability test */
 	if (sched->schedulability_test) {
-		int ok = sched->schedulability_test(tasks, n_tasks);
+		int ok = sched->schedulability_test(tasks, n_tasks, stdout);
 		
 		if (!ok)
 			printf("[Warn] Task set may miss deadlines under %s policy.\n", sched->name);
 	}
 
 	char outpath[512];
-	FILE *trace = rts_trace_open("output", task_file, sched_name, outpath, sizeof(outpath));
-	if (trace) {
+	FILE *trace_fp = NULL;
+	if (trace_on)
+		trace_fp = rts_trace_open_fmt("output", task_file, sched_name, trace_fmt,
+		                              outpath, sizeof(outpath));
+	if (trace_fp) {
 		printf("[trace] writing to %s\n\n", outpath);
 	}
 
+	struct rts_trace trace;
+	rts_trace_init(&trace, trace_fp, trace_fmt);
+
+	struct rts_log log;
+
 	/* Simulation context */
 	struct rts_sim sim = {
 	    .tasks = tasks,
@@ -84,22 +706,398 @@ int main(int argc, char *argv[]) {
 	    .clock = 0,
 	    .missed_jobs = 0,
 	    .total_jobs = 0,
-	    .trace_fp = trace,
+	    .trace = trace_fp ? &trace : NULL,
+	    .rq_ops = rq_ops,
+	    .steady = steady,
+	    .log = &log,
+	    .report = report,
+	    .name = task_file,
+	    .task_stats = task_stats_alloc(task_stats, tasks, n_tasks),
+	    .switch_cost = switch_cost,
 	};
-	rts_rq_init(&sim.ready_queue);
 	sim.running = NULL;
 
+	/* Console output is formatted here and written by a background thread */
+	rts_log_open(&log, stdout, log_level, log_async);
+
 	/* Run simulation */
-	rts_sim_run(&sim, sched, lcm, max_phase);
+	if (engine == RTS_ENGINE_EVENT)
+		rts_sim_run_event(&sim, sched, lcm, max_phase);
+	else
+		rts_sim_run(&sim, sched, lcm, max_phase);
 
-	printf("Simulation complete. Misses=%d, Jobs=%d\n",
+	rts_log_close(&log);
+	sim.log = NULL;
+
+	printf("Simulation complete. Misses=%" PRId64 ", Jobs=%" PRId64 "\n",
 	       sim.missed_jobs, sim.total_jobs);
+	printf("Preemptions=%ld, Switches=%ld, Overhead=%" PRId64 "\n",
+	       sim.preemptions, sim.switches, sim.overhead);
+	if (sim.cycle_len)
+		printf("Steady state from t=%" PRId64 ", repeating every %" PRId64 "\n",
+		       sim.cycle_start, sim.cycle_len);
+	if (sim.task_stats)
+		rts_task_stats_print(sim.task_stats, n_tasks, stdout);
+	free(sim.task_stats);
 
-	if (trace) {
-		fclose(trace);
-		sim.trace_fp = NULL;
-	}
+	rts_trace_close(&trace);
+	sim.trace = NULL;
 
 	free(tasks);
 	return 0;
 }
+
+/**
+ * main - entry point
+ * @argc: argument count
+ * @argv: [options...] scheduler name, task file
+ *
+ * Options:
+ *     --engine=tick|event   simulation engine (default: tick)
+ *     --rq=list|heap        ready queue backend (default: the policy's
+ *                           own, else list)
+ *     --trace-format=tick|interval|binary
+ *                           trace file format (default: tick)
+ *     --no-trace            do not write trace files
+ *     --verbosity=summary|events|full
+ *                           console detail (default: full, i.e. the ready
+ *                           queue on every step)
+ *     --sync-log            write console output from the simulation thread
+ *                           instead of a background writer
+ *     --analyze             print the policy's exact schedulability analysis
+ *                           (e.g. per-task response times for RM) instead
+ *                           of simulating; exit status 0 if schedulable,
+ *                           2 if not
+ *     --steady              stop once the schedule provably repeats at a
+ *                           hyperperiod boundary, instead of at LCM +
+ *                           max phase
+ *     --cores=M             partitioned multiprocessor: bin-pack the tasks
+ *                           onto M cores and simulate each core on its own
+ *                           thread; one merged trace, honours --no-trace
+ *     --partition=ffd|wfd|bfd
+ *                           bin-packing heuristic for --cores: first-,
+ *                           worst- or best-fit decreasing (default: ffd)
+ *     --global              with --cores, schedule globally instead: one
+ *                           ready queue feeds all M cores and the M
+ *                           highest-priority jobs run (G-EDF, G-RM,
+ *                           G-NP-EDF, ...);
+ *                           reports preemptions and migrations per task
+ *     --stats=FILE          append a one-line JSON report per simulation
+ *                           to FILE ("-": stdout): job counts, preemptions,
+ *                           switches, switch overhead, trace bytes and, in
+ *                           STATS=1 builds, hot-path
+ *                           counters; also for batch, lockstep and --cores
+ *     --task-stats          record every task's response time, lateness
+ *                           and start delay (release to first dispatch) in
+ *                           fixed-size histograms; prints min/mean/p99/max
+ *                           and jitter per task and adds them to --stats
+ *                           reports (batch mode: reports only)
+ *     --switch-cost=N       charge N time units to every job that preempts
+ *                           another (context switch and cache reload), on
+ *                           top of its WCET, and report the switch count
+ *                           and total overhead; applies to every mode
+ *     --sensitivity[=TASK]  binary-search the largest factor by which every
+ *                           WCET (or only task TASK's, numbered from 1)
+ *                           can be scaled before each selected policy
+ *                           (--policies, default: all) misses a deadline,
+ *                           and print it with the breakdown utilization;
+ *                           uses the exact analysis where the policy has
+ *                           one and switches are free, else simulates up
+ *                           to the first miss
+ *     --gen=SPEC            write a synthetic task set to the next
+ *                           argument (else stdout) and exit; SPEC is
+ *                           "key=value,..." with keys n, u, split
+ *                           (uunifast|discard), periods (loguniform|
+ *                           harmonic|divisor), tmin, tmax, deadlines
+ *                           (implicit|constrained), phased, seed
+ *     --trace-to-ticks      convert the interval/binary trace named by the
+ *                           next argument to tick text (to the optional
+ *                           following file, else stdout) and exit
+ *     --tasks-to-binary     convert the task set named by the next argument
+ *                           to the binary task set format (to the optional
+ *                           following file, else stdout) and exit; task
+ *                           files in either format are accepted everywhere
+ *
+ * Batch mode (remaining arguments are task files or glob patterns):
+ *     --batch               run every file under every policy in parallel
+ *     --jobs=N              worker threads (default: one per CPU)
+ *     --policies=A,B        policies to run (default: all registered)
+ *     --manifest=FILE       read task files / globs from FILE, one per line
+ *     --no-trace            do not write trace files; needed when two
+ *                           files share a name (a/t.txt, b/t.txt), whose
+ *                           traces would both go to output/t/
+ *
+ * Lockstep mode (remaining argument is one task file):
+ *     --lockstep            run the selected policies (--policies, default:
+ *                           all registered) side by side from one shared
+ *                           arrival stream; honours --no-trace
+ *
+ * Example:
+ *     ./rtsim EDF task.txt
+ *     ./rtsim --engine=event EDF task.txt
+ *     ./rtsim --rq=heap LST task.txt
+ *     ./rtsim --batch --jobs=8 --policies=RM,EDF 'input/test?.txt'
+ *     ./rtsim --lockstep --engine=event task.txt
+ *     ./rtsim --cores=4 --partition=wfd EDF task.txt
+ *     ./rtsim --cores=4 --global EDF task.txt
+ *     ./rtsim --batch --no-trace --stats=runs.jsonl 'input/test?.txt'
+ *     ./rtsim --engine=event --verbosity=summary --task-stats RM task.txt
+ *     ./rtsim --sensitivity --policies=RM,EDF task.txt
+ *     ./rtsim --lockstep --switch-cost=1 --policies=RM,NP-RM,RM-PT task.txt
+ *     ./rtsim --gen=n=1000,u=0.9,periods=harmonic,tmin=2560,tmax=40960,seed=7 big.txt
+ *     ./rtsim --tasks-to-binary big.txt big.tsb
+ */
+int main(int argc, char *argv[]) {
+	int engine = RTS_ENGINE_TICK;
+	const struct rts_rq_ops *rq_ops = NULL;
+	int argi = 1;
+
+	int batch = 0;
+	int lockstep = 0;
+	int n_workers = 0;
+	int trace_on = 1;
+	int trace_fmt = RTS_TRACE_TICK;
+	int convert = 0;
+	int to_binary = 0;
+	int log_level = RTS_LOG_FULL;
+	int log_async = 1;
+	int steady = 0;
+	int analyze = 0;
+	int n_cores = 0;
+	int fit = RTS_PART_FFD;
+	int global = 0;
+	const char *policies = NULL;
+	const char *manifest = NULL;
+	const char *gen_spec = NULL;
+	const char *stats_path = NULL;
+	int task_stats = 0;
+	int sensitivity = 0;
+	int sens_target = RTS_SENS_ALL;
+	int switch_cost = 0;
+	FILE *report = NULL;
+	int status = 0;
+
+	for (; argi < argc && strncmp(argv[argi], "--", 2) == 0; argi++) {
+		const char *opt = argv[argi];
+
+		if (strncmp(opt, "--engine=", 9) == 0) {
+			engine = rts_engine_from_name(opt + 9);
+			if (engine < 0) {
+				fprintf(stderr, "Error: Unknown engine '%s'\n", opt + 9);
+				return 1;
+			}
+		} else if (strncmp(opt, "--rq=", 5) == 0) {
+			rq_ops = rts_rq_ops_from_name(opt + 5);
+			if (!rq_ops)
+				return 1;
+		} else if (strcmp(opt, "--batch") == 0) {
+			batch = 1;
+		} else if (strcmp(opt, "--lockstep") == 0) {
+			lockstep = 1;
+		} else if (strncmp(opt, "--jobs=", 7) == 0) {
+			n_workers = atoi(opt + 7);
+		} else if (strncmp(opt, "--policies=", 11) == 0) {
+			policies = opt + 11;
+		} else if (strncmp(opt, "--manifest=", 11) == 0) {
+			manifest = opt + 11;
+		} else if (strcmp(opt, "--no-trace") == 0) {
+			trace_on = 0;
+		} else if (strncmp(opt, "--trace-format=", 15) == 0) {
+			trace_fmt = rts_trace_format_from_name(opt + 15);
+			if (trace_fmt < 0) {
+				fprintf(stderr, "Error: Unknown trace format '%s'\n", opt + 15);
+				return 1;
+			}
+		} else if (strncmp(opt, "--stats=", 8) == 0) {
+			stats_path = opt + 8;
+		} else if (strcmp(opt, "--task-stats") == 0) {
+			task_stats = 1;
+		} else if (strcmp(opt, "--sensitivity") == 0) {
+			sensitivity = 1;
+		} else if (strncmp(opt, "--sensitivity=", 14) == 0) {
+			sensitivity = 1;
+			sens_target = atoi(opt + 14) - 1;
+			if (sens_target < 0) {
+				fprintf(stderr, "Error: --sensitivity needs a task number from 1\n");
+				return 1;
+			}
+		} else if (strncmp(opt, "--switch-cost=", 14) == 0) {
+			switch_cost = atoi(opt + 14);
+			if (switch_cost < 0) {
+				fprintf(stderr, "Error: --switch-cost cannot be negative\n");
+				return 1;
+			}
+		} else if (strncmp(opt, "--gen=", 6) == 0) {
+			gen_spec = opt + 6;
+		} else if (strcmp(opt, "--trace-to-ticks") == 0) {
+			convert = 1;
+		} else if (strcmp(opt, "--tasks-to-binary") == 0) {
+			to_binary = 1;
+		} else if (strncmp(opt, "--verbosity=", 12) == 0) {
+			log_level = rts_log_level_from_name(opt + 12);
+			if (log_level < 0) {
+				fprintf(stderr, "Error: Unknown verbosity '%s'\n", opt + 12);
+				return 1;
+			}
+		} else if (strcmp(opt, "--sync-log") == 0) {
+			log_async = 0;
+		} else if (strcmp(opt, "--steady") == 0) {
+			steady = 1;
+		} else if (strcmp(opt, "--analyze") == 0) {
+			analyze = 1;
+		} else if (strncmp(opt, "--cores=", 8) == 0) {
+			n_cores = atoi(opt + 8);
+			if (n_cores < 1) {
+				fprintf(stderr, "Error: --cores needs a positive count\n");
+				return 1;
+			}
+		} else if (strcmp(opt, "--global") == 0) {
+			global = 1;
+		} else if (strncmp(opt, "--partition=", 12) == 0) {
+			fit = rts_partition_fit_from_name(opt + 12);
+			if (fit < 0) {
+				fprintf(stderr, "Error: Unknown partitioning heuristic '%s'\n", opt + 12);
+				return 1;
+			}
+		} else {
+			fprintf(stderr, "Error: Unknown option '%s'\n", opt);
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (gen_spec)
+		return run_gen(gen_spec, argc - argi > 0 ? argv[argi] : NULL);
+
+	if (convert) {
+		if (argc - argi < 1) {
+			usage(argv[0]);
+			return 1;
+		}
+
+		return trace_to_ticks(argv[argi], argc - argi > 1 ? argv[argi + 1] : NULL);
+	}
+
+	if (to_binary) {
+		if (argc - argi < 1) {
+			usage(argv[0]);
+			return 1;
+		}
+
+		return tasks_to_binary(argv[argi], argc - argi > 1 ? argv[argi + 1] : NULL);
+	}
+
+	if (sensitivity) {
+		if (argc - argi != 1) {
+			usage(argv[0]);
+			return 1;
+		}
+
+		return run_sensitivity(argv[argi], policies, rq_ops, sens_target, switch_cost);
+	}
+
+	if (global && !n_cores) {
+		fprintf(stderr, "Error: --global needs --cores=M\n");
+		return 1;
+	}
+
+	if (global && steady) {
+		fprintf(stderr, "Error: --steady is not supported with --global\n");
+		return 1;
+	}
+
+	if (n_cores && (batch || lockstep || analyze)) {
+		fprintf(stderr, "Error: --cores is not supported with --batch, --lockstep or --analyze\n");
+		return 1;
+	}
+
+	if (batch && task_stats && !stats_path) {
+		fprintf(stderr, "Error: --task-stats with --batch needs --stats=FILE\n");
+		return 1;
+	}
+
+	if (stats_path) {
+		report = strcmp(stats_path, "-") == 0 ? stdout : fopen(stats_path, "a");
+		if (!report) {
+			perror("open stats file");
+			return 1;
+		}
+	}
+
+	if (batch) {
+		struct rts_batch_opts opts = {
+		    .rq_ops = rq_ops,
+		    .engine = engine,
+		    .n_workers = n_workers,
+		    .outdir = trace_on ? "output" : NULL,
+		    .trace_fmt = trace_fmt,
+		    .steady = steady,
+		    .report = report,
+		    .task_stats = task_stats,
+		    .switch_cost = switch_cost,
+		};
+
+		status = run_batch(&opts, policies, manifest, &argv[argi], argc - argi);
+		goto out;
+	}
+
+	if (lockstep) {
+		if (steady) {
+			fprintf(stderr, "Error: --steady is not supported with --lockstep\n");
+			status = 1;
+		} else if (argc - argi != 1) {
+			usage(argv[0]);
+			status = 1;
+		} else {
+			status = run_lockstep(argv[argi], policies, rq_ops, engine,
+			                      trace_on, trace_fmt, report, task_stats,
+			                      switch_cost);
+		}
+		goto out;
+	}
+
+	if (argc - argi < 2) {
+		usage(argv[0]);
+		status = 1;
+		goto out;
+	}
+
+	const char *sched_name = argv[argi];
+	const char *task_file = argv[argi + 1];
+
+	if (analyze) {
+		status = run_analysis(sched_name, task_file);
+		goto out;
+	}
+
+	if (global) {
+		status = run_global(sched_name, task_file, n_cores, rq_ops, engine,
+		                    trace_on, trace_fmt, log_level, log_async, report,
+		                    task_stats, switch_cost);
+		goto out;
+	}
+
+	if (n_cores) {
+		struct rts_partition_opts popts = {
+		    .rq_ops = rq_ops,
+		    .engine = engine,
+		    .steady = steady,
+		    .trace = trace_on,
+		    .report = report,
+		    .switch_cost = switch_cost,
+		};
+
+		status = run_partitioned(sched_name, task_file, n_cores, fit, &popts, trace_fmt,
+		                         task_stats);
+		goto out;
+	}
+
+	status = run_single(sched_name, task_file, rq_ops, engine, trace_on, trace_fmt,
+	                    steady, log_level, log_async, report, task_stats,
+	                    switch_cost);
+
+out:
+	if (report && report != stdout)
+		fclose(report);
+	return status;
+}
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_rq_core.c
+ * @brief Common helper functions for all ready queue backends.
+ */
+#include "rts_rq.h"
+#include "rts_sched.h"
+#include "rts_types.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Ready Queue Backend Registry Table
+ * @NULL: terminated array for easy iteration
+ *
+ * Only policy-agnostic backends are listed; specialized ones such as
+ * rts_rq_lst_ops are attached to their scheduler class instead.
+ */
+static const struct rts_rq_ops * const available_rq_backends[] = {
+    &rts_rq_list_ops,
+    &rts_rq_heap_ops,
+    NULL
+};
+
+const struct rts_rq_ops *rts_rq_ops_from_name(const char *name) {
+    if (name && *name) {
+        for (size_t i = 0; available_rq_backends[i] != NULL; i++) {
+            if (strcmp(name, available_rq_backends[i]->name) == 0) {
+                return available_rq_backends[i];
+            }
+        }
+    }
+
+    fprintf(stderr, "Error: Unknown ready queue '%s'\n", name ? name : "");
+    fprintf(stderr, "Available: ");
+    for (size_t i = 0; available_rq_backends[i] != NULL; i++) {
+        fprintf(stderr, "%s ", available_rq_backends[i]->name);
+    }
+    fprintf(stderr, "\n");
+
+    return NULL;
+}
+
+/**
+ * rq_specialize - the copy of generic backend @ops for built-in order @prio
+ *
+ * Other backends, and classes ordered only by their higher_prio(), keep
+ * @ops.
+ */
+static const struct rts_rq_ops *rq_specialize(const struct rts_rq_ops *ops, int prio) {
+	static const struct rts_rq_ops * const list[RTS_PRIO_NR] = {
+	    [RTS_PRIO_CUSTOM] = &rts_rq_list_ops,
+#define RQ_LIST_VARIANT(NAME, name) [RTS_PRIO_##NAME] = &rts_rq_list_##name##_ops,
+	    RTS_PRIO_BUILTIN(RQ_LIST_VARIANT)
+#undef RQ_LIST_VARIANT
+	};
+	static const struct rts_rq_ops * const heap[RTS_PRIO_NR] = {
+	    [RTS_PRIO_CUSTOM] = &rts_rq_heap_ops,
+#define RQ_HEAP_VARIANT(NAME, name) [RTS_PRIO_##NAME] = &rts_rq_heap_##name##_ops,
+	    RTS_PRIO_BUILTIN(RQ_HEAP_VARIANT)
+#undef RQ_HEAP_VARIANT
+	};
+
+	if (prio <= RTS_PRIO_CUSTOM || prio >= RTS_PRIO_NR)
+		return ops;
+	if (ops == &rts_rq_list_ops)
+		return list[prio];
+	if (ops == &rts_rq_heap_ops)
+		return heap[prio];
+	return ops;
+}
+
+int rts_rq_setup(struct rts_rq *rq,
+                 const struct rts_rq_ops *ops,
+                 const struct rts_sched_class *sched,
+                 const struct rts_task *tasks,
+                 const rts_time_t *clock) {
+	if (!ops)
+		ops = sched->rq_ops ? sched->rq_ops : &rts_rq_list_ops;
+
+	rq->ops = rq_specialize(ops, sched->prio);
+	rq->sched = sched;
+	rq->tasks = tasks;
+	rq->clock = clock;
+	rq->stats = NULL;
+	rq->heap = NULL;
+	rq->nr = 0;
+	rq->cap = 0;
+	rq->cur = NULL;
+	rts_rq_init(&rq->jobs);
+
+	if (rts_rq_dl_init(rq) != 0)
+		return -1;
+	if (rq->ops->init(rq) != 0) {
+		rts_rq_dl_destroy(rq);
+		return -1;
+	}
+
+	return 0;
+}
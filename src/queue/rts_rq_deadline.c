@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_rq_deadline.c
+ * @brief Deadline index of the ready queue (binary min-heap).
+ *
+ * Keyed on the latest feasible start abs_deadline - remain, independent of
+ * the backend's priority order, so the simulator finds late jobs and the
+ * next imminent miss without walking the queue.
+ */
+#include "rts_rq.h"
+#include "rts_types.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define RQ_DL_INIT_CAP 16
+
+static inline rts_time_t rq_dl_key(const struct rts_job *job) {
+	return job->abs_deadline - job->remain;
+}
+
+/* True if @a is due before @b; ties by release order */
+static inline int rq_dl_before(const struct rts_job *a, const struct rts_job *b) {
+	rts_time_t ka = rq_dl_key(a);
+	rts_time_t kb = rq_dl_key(b);
+
+	if (ka != kb)
+		return ka < kb;
+	if (a->release_time != b->release_time)
+		return a->release_time < b->release_time;
+	if (a->tid != b->tid)
+		return a->tid < b->tid;
+	return a->jid < b->jid;
+}
+
+static inline void rq_dl_set(struct rts_rq *rq, int i, struct rts_job *job) {
+	rq->dl[i] = job;
+	job->didx = i;
+}
+
+static void rq_dl_sift_up(struct rts_rq *rq, int i) {
+	struct rts_job *job = rq->dl[i];
+
+	while (i > 0) {
+		int parent = (i - 1) / 2;
+		if (!rq_dl_before(job, rq->dl[parent]))
+			break;
+		rq_dl_set(rq, i, rq->dl[parent]);
+		i = parent;
+	}
+	rq_dl_set(rq, i, job);
+}
+
+static void rq_dl_sift_down(struct rts_rq *rq, int i) {
+	struct rts_job *job = rq->dl[i];
+
+	for (;;) {
+		int child = 2 * i + 1;
+		if (child >= rq->dl_nr)
+			break;
+		if (child + 1 < rq->dl_nr && rq_dl_before(rq->dl[child + 1], rq->dl[child]))
+			child++;
+		if (!rq_dl_before(rq->dl[child], job))
+			break;
+		rq_dl_set(rq, i, rq->dl[child]);
+		i = child;
+	}
+	rq_dl_set(rq, i, job);
+}
+
+int rts_rq_dl_init(struct rts_rq *rq) {
+	rq->dl = malloc(sizeof(*rq->dl) * RQ_DL_INIT_CAP);
+	rq->dl_nr = 0;
+	rq->dl_cap = rq->dl ? RQ_DL_INIT_CAP : 0;
+	return rq->dl ? 0 : -1;
+}
+
+void rts_rq_dl_destroy(struct rts_rq *rq) {
+	free(rq->dl);
+	rq->dl = NULL;
+	rq->dl_nr = 0;
+	rq->dl_cap = 0;
+}
+
+void rts_rq_dl_insert(struct rts_rq *rq, struct rts_job *job) {
+	if (rq->dl_nr == rq->dl_cap) {
+		int cap = rq->dl_cap * 2;
+		struct rts_job **tmp = realloc(rq->dl, sizeof(*tmp) * cap);
+
+		if (!tmp) {
+			fprintf(stderr, "[rq] out of memory growing deadline index to %d\n", cap);
+			exit(EXIT_FAILURE);
+		}
+
+		rq->dl = tmp;
+		rq->dl_cap = cap;
+	}
+
+	rq_dl_set(rq, rq->dl_nr++, job);
+	rq_dl_sift_up(rq, job->didx);
+}
+
+void rts_rq_dl_remove(struct rts_rq *rq, struct rts_job *job) {
+	int i = job->didx;
+	struct rts_job *last = rq->dl[--rq->dl_nr];
+
+	job->didx = -1;
+	if (last == job)
+		return;
+
+	rq_dl_set(rq, i, last);
+	rts_rq_dl_update(rq, last);
+}
+
+void rts_rq_dl_update(struct rts_rq *rq, struct rts_job *job) {
+	int i = job->didx;
+
+	if (i > 0 && rq_dl_before(job, rq->dl[(i - 1) / 2]))
+		rq_dl_sift_up(rq, i);
+	else
+		rq_dl_sift_down(rq, i);
+}
+
+rts_time_t rts_rq_dl_next(const struct rts_rq *rq, const struct rts_job *skip) {
+	if (!rq->dl_nr)
+		return RTS_TIME_MAX;
+	if (rq->dl[0] != skip)
+		return rq_dl_key(rq->dl[0]);
+
+	/* The runner-up is one of the root's children */
+	rts_time_t next = RTS_TIME_MAX;
+	for (int i = 1; i <= 2 && i < rq->dl_nr; i++) {
+		if (rq_dl_key(rq->dl[i]) < next)
+			next = rq_dl_key(rq->dl[i]);
+	}
+	return next;
+}
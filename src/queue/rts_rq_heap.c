@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_rq_heap.c
+ * @brief Ready queue implementation using a binary heap.
+ *
+ * Jobs are ordered by the scheduler's higher_prio(); equal-priority jobs
+ * keep arrival order.  Insert, remove and update are O(log n), peek is O(1).
+ * Every queued job is also linked on rq->jobs so callers can iterate it.
+ *
+ * The comparing operations are instantiated from rts_rq_heap_tmpl.h for
+ * the generic higher_prio() call and for every built-in order.
+ */
+#include "rts_rq.h"
+#include "rts_sched.h"
+#include "rts_types.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define RQ_HEAP_INIT_CAP 16
+
+static inline void rq_heap_set(struct rts_rq *rq, int i, struct rts_job *job) {
+	rq->heap[i] = job;
+	job->hidx = i;
+}
+
+/* Make room for one more entry */
+static void rq_heap_reserve(struct rts_rq *rq) {
+	if (rq->nr < rq->cap)
+		return;
+
+	int cap = rq->cap * 2;
+	struct rts_job **tmp = realloc(rq->heap, sizeof(*tmp) * cap);
+
+	if (!tmp) {
+		fprintf(stderr, "[rq] out of memory growing heap to %d\n", cap);
+		exit(EXIT_FAILURE);
+	}
+
+	rq->heap = tmp;
+	rq->cap = cap;
+}
+
+static int rq_heap_init(struct rts_rq *rq) {
+	rq->heap = malloc(sizeof(*rq->heap) * RQ_HEAP_INIT_CAP);
+	if (!rq->heap)
+		return -1;
+
+	rq->cap = RQ_HEAP_INIT_CAP;
+	rq->nr = 0;
+	return 0;
+}
+
+static void rq_heap_destroy(struct rts_rq *rq) {
+	free(rq->heap);
+	rq->heap = NULL;
+	rq->nr = 0;
+	rq->cap = 0;
+}
+
+static struct rts_job *rq_heap_peek(struct rts_rq *rq) {
+	return rq->nr ? rq->heap[0] : NULL;
+}
+
+#define RQ_FN(fn)    rq_heap_##fn
+#define RQ_HIGHER    rts_rq_higher
+#define RQ_OPS       rts_rq_heap_ops
+#include "rts_rq_heap_tmpl.h"
+
+#define RQ_FN(fn)    rq_heap_rm_##fn
+#define RQ_HIGHER    rts_rq_higher_rm
+#define RQ_OPS       rts_rq_heap_rm_ops
+#include "rts_rq_heap_tmpl.h"
+
+#define RQ_FN(fn)    rq_heap_edf_##fn
+#define RQ_HIGHER    rts_rq_higher_edf
+#define RQ_OPS       rts_rq_heap_edf_ops
+#include "rts_rq_heap_tmpl.h"
+
+#define RQ_FN(fn)    rq_heap_lst_##fn
+#define RQ_HIGHER    rts_rq_higher_lst
+#define RQ_OPS       rts_rq_heap_lst_ops
+#include "rts_rq_heap_tmpl.h"
+
+#define RQ_FN(fn)    rq_heap_np_rm_##fn
+#define RQ_HIGHER    rts_rq_higher_np_rm
+#define RQ_OPS       rts_rq_heap_np_rm_ops
+#include "rts_rq_heap_tmpl.h"
+
+#define RQ_FN(fn)    rq_heap_np_edf_##fn
+#define RQ_HIGHER    rts_rq_higher_np_edf
+#define RQ_OPS       rts_rq_heap_np_edf_ops
+#include "rts_rq_heap_tmpl.h"
+
+#define RQ_FN(fn)    rq_heap_rm_pt_##fn
+#define RQ_HIGHER    rts_rq_higher_rm_pt
+#define RQ_OPS       rts_rq_heap_rm_pt_ops
+#include "rts_rq_heap_tmpl.h"
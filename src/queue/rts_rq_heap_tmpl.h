@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_rq_heap_tmpl.h
+ * @brief Heap backend body, instantiated once per priority order.
+ *
+ * No include guard: rts_rq_heap.c includes this once per copy, after
+ * defining
+ *   RQ_FN(fn)           name of each function of the copy
+ *   RQ_HIGHER(rq, a, b) counted priority comparison
+ *   RQ_OPS              name of the exported struct rts_rq_ops
+ * which are undefined again at the end.
+ */
+
+/**
+ * before - heap order: true if @a must be served before @b
+ *
+ * Ties under higher_prio() fall back to release order, which is the order
+ * the list backend would have kept them in.
+ */
+static inline int RQ_FN(before)(const struct rts_rq *rq,
+                                const struct rts_job *a,
+                                const struct rts_job *b) {
+	if (RQ_HIGHER(rq, a, b))
+		return 1;
+	if (RQ_HIGHER(rq, b, a))
+		return 0;
+
+	if (a->release_time != b->release_time)
+		return a->release_time < b->release_time;
+	if (a->tid != b->tid)
+		return a->tid < b->tid;
+	return a->jid < b->jid;
+}
+
+static void RQ_FN(sift_up)(struct rts_rq *rq, int i) {
+	struct rts_job *job = rq->heap[i];
+
+	while (i > 0) {
+		int parent = (i - 1) / 2;
+		if (!RQ_FN(before)(rq, job, rq->heap[parent]))
+			break;
+		rq_heap_set(rq, i, rq->heap[parent]);
+		i = parent;
+	}
+	rq_heap_set(rq, i, job);
+}
+
+static void RQ_FN(sift_down)(struct rts_rq *rq, int i) {
+	struct rts_job *job = rq->heap[i];
+
+	for (;;) {
+		int child = 2 * i + 1;
+		if (child >= rq->nr)
+			break;
+		if (child + 1 < rq->nr &&
+		    RQ_FN(before)(rq, rq->heap[child + 1], rq->heap[child]))
+			child++;
+		if (!RQ_FN(before)(rq, rq->heap[child], job))
+			break;
+		rq_heap_set(rq, i, rq->heap[child]);
+		i = child;
+	}
+	rq_heap_set(rq, i, job);
+}
+
+static void RQ_FN(insert)(struct rts_rq *rq, struct rts_job *job) {
+	rq_heap_reserve(rq);
+	rts_list_add_tail(&job->qnode, &rq->jobs);
+
+	rq_heap_set(rq, rq->nr++, job);
+	RQ_FN(sift_up)(rq, job->hidx);
+}
+
+static void RQ_FN(remove)(struct rts_rq *rq, struct rts_job *job) {
+	int i = job->hidx;
+	struct rts_job *last = rq->heap[--rq->nr];
+
+	rts_list_del(&job->qnode);
+	job->hidx = -1;
+
+	if (last == job)
+		return;
+
+	rq_heap_set(rq, i, last);
+	if (i > 0 && RQ_FN(before)(rq, last, rq->heap[(i - 1) / 2]))
+		RQ_FN(sift_up)(rq, i);
+	else
+		RQ_FN(sift_down)(rq, i);
+}
+
+static struct rts_job *RQ_FN(pop)(struct rts_rq *rq) {
+	struct rts_job *j = rq_heap_peek(rq);
+	if (j)
+		RQ_FN(remove)(rq, j);
+	return j;
+}
+
+static void RQ_FN(update)(struct rts_rq *rq, struct rts_job *job) {
+	int i = job->hidx;
+
+	if (i > 0 && RQ_FN(before)(rq, job, rq->heap[(i - 1) / 2]))
+		RQ_FN(sift_up)(rq, i);
+	else
+		RQ_FN(sift_down)(rq, i);
+}
+
+const struct rts_rq_ops RQ_OPS = {
+    .name = "heap",
+    .init = rq_heap_init,
+    .destroy = rq_heap_destroy,
+    .insert = RQ_FN(insert),
+    .peek = rq_heap_peek,
+    .pop = RQ_FN(pop),
+    .remove = RQ_FN(remove),
+    .update = RQ_FN(update),
+};
+
+#undef RQ_FN
+#undef RQ_HIGHER
+#undef RQ_OPS
@@ -5,9 +5,12 @@
  *
  * This module provides basic ready queue operations.
  */
+#include "rts_log.h"
+#include "rts_rq.h"
 #include "rts_sched.h"
 #include "rts_types.h"
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -42,34 +45,6 @@ struct rts_job *rts_rq_dequeue(struct rts_list_head *head) {
 	return rts_list_entry(node, struct rts_job, qnode);
 }
 
-/**
- * rts_rq_ordered_insert - insert job by scheduler priority rule
- * @head: ready queue head
- * @job: new job
- * @sched: scheduler class defining higher_prio()
- * @tasks: task set (for lookup)
- * @now: current time
- *
- * Iterate the queue and insert before the first lower-priority job.
- */
-void rts_rq_ordered_insert(struct rts_list_head *head,
-                           struct rts_job *job,
-                           const struct rts_sched_class *sched,
-                           const struct rts_task *tasks,
-                           int now) {
-	struct rts_list_head *pos;
-	for (pos = head->next; pos != head; pos = pos->next) {
-		struct rts_job *cur = rts_list_entry(pos, struct rts_job, qnode);
-		if (sched->higher_prio(job, cur, tasks, now)) {
-			/* insert before cur */
-			rts_list_link_between(&job->qnode, pos->prev, pos);
-			return;
-		}
-	}
-	/* if all have higher priority, append at tail */
-	rts_rq_enqueue(head, job);
-}
-
 /**
  * rts_rq_remove_job - remove a specific job from queue
  * @job: job to remove
@@ -80,18 +55,90 @@ void rts_rq_remove(struct rts_job *job) {
 
 /**
  * rts_rq_dump - dump queue content
+ * @log: log sink (NULL: do nothing)
  * @head: ready queue head
  * @tasks: task set (for metadata)
  */
-void rts_rq_dump(struct rts_list_head *head, const struct rts_task *tasks) {
+void rts_rq_dump(struct rts_log *log, struct rts_list_head *head, const struct rts_task *tasks) {
 	(void)tasks;
 
+	if (!log)
+		return;
+
 	struct rts_list_head *pos;
-	printf("[RQ] ");
-	for (pos = head->next; pos != head; pos = pos->next) {
-		struct rts_job *j = rts_list_entry(pos, struct rts_job, qnode);
-		printf("T%d:J%d(rem=%d,d=%d) -> ",
-		       j->tid + 1, j->jid, j->remain, j->abs_deadline);
-	}
-	printf("END\n\n");
+	rts_log_printf(log, "[RQ] ");
+	for (pos = head->next; pos != head; pos = pos->next)
+		rts_rq_dump_job(log, rts_list_entry(pos, struct rts_job, qnode));
+	rts_log_printf(log, "END\n\n");
+}
+
+/**
+ * rts_rq_dump_job - one entry of a queue dump
+ * @log: log sink
+ * @job: queued job
+ */
+void rts_rq_dump_job(struct rts_log *log, const struct rts_job *job) {
+	rts_log_printf(log, "T%d:J%d(rem=%d,d=%" PRId64 ") -> ",
+	               job->tid + 1, job->jid, job->remain, job->abs_deadline);
+}
+
+/*
+ * List backend: the reference implementation.  Insert is an O(n) ordered
+ * walk and peek rescans the whole queue, since dynamic-priority classes
+ * (LST) can reorder jobs after they were inserted.  The walks are
+ * instantiated from rts_rq_list_tmpl.h for the generic higher_prio()
+ * call and for every built-in order.
+ */
+static int rq_list_init(struct rts_rq *rq) {
+	(void)rq;
+	return 0;
+}
+
+static void rq_list_destroy(struct rts_rq *rq) {
+	(void)rq;
+}
+
+static void rq_list_remove(struct rts_rq *rq, struct rts_job *job) {
+	(void)rq;
+	rts_rq_remove(job);
+}
+
+static void rq_list_update(struct rts_rq *rq, struct rts_job *job) {
+	(void)rq;
+	(void)job;
 }
+
+#define RQ_FN(fn)    rq_list_##fn
+#define RQ_HIGHER    rts_rq_higher
+#define RQ_OPS       rts_rq_list_ops
+#include "rts_rq_list_tmpl.h"
+
+#define RQ_FN(fn)    rq_list_rm_##fn
+#define RQ_HIGHER    rts_rq_higher_rm
+#define RQ_OPS       rts_rq_list_rm_ops
+#include "rts_rq_list_tmpl.h"
+
+#define RQ_FN(fn)    rq_list_edf_##fn
+#define RQ_HIGHER    rts_rq_higher_edf
+#define RQ_OPS       rts_rq_list_edf_ops
+#include "rts_rq_list_tmpl.h"
+
+#define RQ_FN(fn)    rq_list_lst_##fn
+#define RQ_HIGHER    rts_rq_higher_lst
+#define RQ_OPS       rts_rq_list_lst_ops
+#include "rts_rq_list_tmpl.h"
+
+#define RQ_FN(fn)    rq_list_np_rm_##fn
+#define RQ_HIGHER    rts_rq_higher_np_rm
+#define RQ_OPS       rts_rq_list_np_rm_ops
+#include "rts_rq_list_tmpl.h"
+
+#define RQ_FN(fn)    rq_list_np_edf_##fn
+#define RQ_HIGHER    rts_rq_higher_np_edf
+#define RQ_OPS       rts_rq_list_np_edf_ops
+#include "rts_rq_list_tmpl.h"
+
+#define RQ_FN(fn)    rq_list_rm_pt_##fn
+#define RQ_HIGHER    rts_rq_higher_rm_pt
+#define RQ_OPS       rts_rq_list_rm_pt_ops
+#include "rts_rq_list_tmpl.h"
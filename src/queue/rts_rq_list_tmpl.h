@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_rq_list_tmpl.h
+ * @brief List backend body, instantiated once per priority order.
+ *
+ * No include guard: rts_rq_list.c includes this once per copy, after
+ * defining
+ *   RQ_FN(fn)           name of each function of the copy
+ *   RQ_HIGHER(rq, a, b) counted priority comparison
+ *   RQ_OPS              name of the exported struct rts_rq_ops
+ * which are undefined again at the end.
+ */
+
+/**
+ * before - list order: true if @a must be queued ahead of @b
+ *
+ * Ties under higher_prio() fall back to release order, as in the heap
+ * backend, so a job put back after running (global dispatch) goes ahead
+ * of later jobs it ties with instead of behind them.  The reverse
+ * comparison is only made when release order would put @a first, so a
+ * fresh release still costs one comparison per queued job it walks past.
+ */
+static inline int RQ_FN(before)(const struct rts_rq *rq,
+                                const struct rts_job *a,
+                                const struct rts_job *b) {
+	if (RQ_HIGHER(rq, a, b))
+		return 1;
+
+	int first;
+	if (a->release_time != b->release_time)
+		first = a->release_time < b->release_time;
+	else if (a->tid != b->tid)
+		first = a->tid < b->tid;
+	else
+		first = a->jid < b->jid;
+
+	return first && !RQ_HIGHER(rq, b, a);
+}
+
+/* Ordered walk: insert ahead of the first job @job goes before */
+static void RQ_FN(insert)(struct rts_rq *rq, struct rts_job *job) {
+	struct rts_list_head *pos;
+
+	rts_list_for_each(pos, &rq->jobs) {
+		if (RQ_FN(before)(rq, job, rts_list_entry(pos, struct rts_job, qnode))) {
+			rts_list_link_between(&job->qnode, pos->prev, pos);
+			return;
+		}
+	}
+	rts_rq_enqueue(&rq->jobs, job);
+}
+
+static struct rts_job *RQ_FN(peek)(struct rts_rq *rq) {
+	struct rts_list_head *pos;
+	struct rts_job *best = NULL;
+
+	rts_list_for_each(pos, &rq->jobs) {
+		struct rts_job *j = rts_list_entry(pos, struct rts_job, qnode);
+		if (j->remain <= 0) {
+			continue;
+		}
+		if (!best || RQ_HIGHER(rq, j, best)) {
+			best = j;
+		}
+	}
+
+	return best;
+}
+
+static struct rts_job *RQ_FN(pop)(struct rts_rq *rq) {
+	struct rts_job *j = RQ_FN(peek)(rq);
+	if (j)
+		rts_rq_remove(j);
+	return j;
+}
+
+const struct rts_rq_ops RQ_OPS = {
+    .name = "list",
+    .init = rq_list_init,
+    .destroy = rq_list_destroy,
+    .insert = RQ_FN(insert),
+    .peek = RQ_FN(peek),
+    .pop = RQ_FN(pop),
+    .remove = rq_list_remove,
+    .update = rq_list_update,
+};
+
+#undef RQ_FN
+#undef RQ_HIGHER
+#undef RQ_OPS
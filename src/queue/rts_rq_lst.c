@@ -0,0 +1,232 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_rq_lst.c
+ * @brief Ready queue specialized for Least Slack Time (LST).
+ *
+ * Slack is abs_deadline - now - remain.  Every waiting job loses slack at
+ * the same rate, so waiting jobs keep their relative order and can live in
+ * a heap keyed on the time-invariant value abs_deadline - remain.  Only the
+ * running job's key changes; it is held outside the heap in rq->cur and
+ * compared against the heap top on dispatch.  Enqueue and preemption are
+ * O(log n), dispatch without preemption is O(1).
+ */
+#include "rts_log.h"
+#include "rts_rq.h"
+#include "rts_types.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RQ_LST_INIT_CAP 16
+
+/**
+ * rq_lst_key_before - true if waiting job @a must be served before @b
+ *
+ * Same order as lst_higher_prio(), with release order among equal jobs as
+ * in the generic heap backend.
+ */
+static inline int rq_lst_key_before(const struct rts_job *a, const struct rts_job *b) {
+	rts_time_t ka = a->abs_deadline - a->remain;
+	rts_time_t kb = b->abs_deadline - b->remain;
+
+	if (ka != kb)
+		return ka < kb;
+	if (a->tid != b->tid)
+		return a->tid < b->tid;
+	if (a->release_time != b->release_time)
+		return a->release_time < b->release_time;
+	return a->jid < b->jid;
+}
+
+/* rq_lst_key_before(), counted as one higher_prio() call */
+static inline int rq_lst_before(const struct rts_rq *rq,
+                                const struct rts_job *a,
+                                const struct rts_job *b) {
+	rts_stats_cmp(rq->stats);
+	return rq_lst_key_before(a, b);
+}
+
+static inline void rq_lst_set(struct rts_rq *rq, int i, struct rts_job *job) {
+	rq->heap[i] = job;
+	job->hidx = i;
+}
+
+static void rq_lst_sift_up(struct rts_rq *rq, int i) {
+	struct rts_job *job = rq->heap[i];
+
+	while (i > 0) {
+		int parent = (i - 1) / 2;
+		if (!rq_lst_before(rq, job, rq->heap[parent]))
+			break;
+		rq_lst_set(rq, i, rq->heap[parent]);
+		i = parent;
+	}
+	rq_lst_set(rq, i, job);
+}
+
+static void rq_lst_sift_down(struct rts_rq *rq, int i) {
+	struct rts_job *job = rq->heap[i];
+
+	for (;;) {
+		int child = 2 * i + 1;
+		if (child >= rq->nr)
+			break;
+		if (child + 1 < rq->nr &&
+		    rq_lst_before(rq, rq->heap[child + 1], rq->heap[child]))
+			child++;
+		if (!rq_lst_before(rq, rq->heap[child], job))
+			break;
+		rq_lst_set(rq, i, rq->heap[child]);
+		i = child;
+	}
+	rq_lst_set(rq, i, job);
+}
+
+static void rq_lst_heap_push(struct rts_rq *rq, struct rts_job *job) {
+	if (rq->nr == rq->cap) {
+		int cap = rq->cap * 2;
+		struct rts_job **tmp = realloc(rq->heap, sizeof(*tmp) * cap);
+
+		if (!tmp) {
+			fprintf(stderr, "[rq] out of memory growing heap to %d\n", cap);
+			exit(EXIT_FAILURE);
+		}
+
+		rq->heap = tmp;
+		rq->cap = cap;
+	}
+
+	rq_lst_set(rq, rq->nr++, job);
+	rq_lst_sift_up(rq, job->hidx);
+}
+
+static void rq_lst_heap_del(struct rts_rq *rq, struct rts_job *job) {
+	int i = job->hidx;
+	struct rts_job *last = rq->heap[--rq->nr];
+
+	job->hidx = -1;
+	if (last == job)
+		return;
+
+	rq_lst_set(rq, i, last);
+	if (i > 0 && rq_lst_before(rq, last, rq->heap[(i - 1) / 2]))
+		rq_lst_sift_up(rq, i);
+	else
+		rq_lst_sift_down(rq, i);
+}
+
+static int rq_lst_init(struct rts_rq *rq) {
+	rq->heap = malloc(sizeof(*rq->heap) * RQ_LST_INIT_CAP);
+	if (!rq->heap)
+		return -1;
+
+	rq->cap = RQ_LST_INIT_CAP;
+	rq->nr = 0;
+	rq->cur = NULL;
+	return 0;
+}
+
+static void rq_lst_destroy(struct rts_rq *rq) {
+	free(rq->heap);
+	rq->heap = NULL;
+	rq->nr = 0;
+	rq->cap = 0;
+	rq->cur = NULL;
+}
+
+static void rq_lst_insert(struct rts_rq *rq, struct rts_job *job) {
+	rts_list_add_tail(&job->qnode, &rq->jobs);
+	rq_lst_heap_push(rq, job);
+}
+
+static struct rts_job *rq_lst_peek(struct rts_rq *rq) {
+	if (!rq->nr)
+		return rq->cur;
+
+	struct rts_job *top = rq->heap[0];
+
+	if (!rq->cur) {
+		rq_lst_heap_del(rq, top);
+		rq->cur = top;
+	} else if (rq_lst_before(rq, top, rq->cur)) {
+		/* Preemption: park the running job and promote the top */
+		rq_lst_heap_del(rq, top);
+		rq_lst_heap_push(rq, rq->cur);
+		rq->cur = top;
+	}
+
+	return rq->cur;
+}
+
+static void rq_lst_remove(struct rts_rq *rq, struct rts_job *job) {
+	rts_list_del(&job->qnode);
+
+	if (job == rq->cur)
+		rq->cur = NULL;
+	else
+		rq_lst_heap_del(rq, job);
+}
+
+static struct rts_job *rq_lst_pop(struct rts_rq *rq) {
+	struct rts_job *j = rq_lst_peek(rq);
+	if (j)
+		rq_lst_remove(rq, j);
+	return j;
+}
+
+static void rq_lst_update(struct rts_rq *rq, struct rts_job *job) {
+	/* The running job is compared afresh on every peek */
+	if (job == rq->cur)
+		return;
+
+	int i = job->hidx;
+	if (i > 0 && rq_lst_before(rq, job, rq->heap[(i - 1) / 2]))
+		rq_lst_sift_up(rq, i);
+	else
+		rq_lst_sift_down(rq, i);
+}
+
+static int rq_lst_cmp(const void *pa, const void *pb) {
+	const struct rts_job *a = *(const struct rts_job *const *)pa;
+	const struct rts_job *b = *(const struct rts_job *const *)pb;
+
+	return rq_lst_key_before(a, b) ? -1 : rq_lst_key_before(b, a);
+}
+
+/*
+ * rq->jobs is in arrival order here, so print the running job and then a
+ * sorted copy of the heap; not counted, as it is not a scheduling decision
+ */
+static void rq_lst_dump(struct rts_rq *rq, struct rts_log *log) {
+	struct rts_job **order = malloc(sizeof(*order) * (rq->nr > 0 ? rq->nr : 1));
+
+	if (!order) {
+		rts_rq_dump(log, &rq->jobs, rq->tasks);
+		return;
+	}
+
+	memcpy(order, rq->heap, sizeof(*order) * rq->nr);
+	qsort(order, (size_t)rq->nr, sizeof(*order), rq_lst_cmp);
+
+	rts_log_printf(log, "[RQ] ");
+	if (rq->cur)
+		rts_rq_dump_job(log, rq->cur);
+	for (int i = 0; i < rq->nr; i++)
+		rts_rq_dump_job(log, order[i]);
+	rts_log_printf(log, "END\n\n");
+
+	free(order);
+}
+
+const struct rts_rq_ops rts_rq_lst_ops = {
+    .name = "lst",
+    .init = rq_lst_init,
+    .destroy = rq_lst_destroy,
+    .insert = rq_lst_insert,
+    .peek = rq_lst_peek,
+    .pop = rq_lst_pop,
+    .remove = rq_lst_remove,
+    .update = rq_lst_update,
+    .dump = rq_lst_dump,
+};
@@ -0,0 +1,466 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_analysis.c
+ * @brief Analytic schedulability tests.
+ */
+#include "rts_analysis.h"
+#include "rts_types.h"
+#include "rts_util.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+static inline rts_time_t rta_ceil_div(rts_time_t a, rts_time_t b) {
+	return (a + b - 1) / b;
+}
+
+/**
+ * rta_hp_demand - work released by the tasks ranked above @pos in [0, @w)
+ */
+static rts_time_t rta_hp_demand(const struct rts_task *tasks, const int *order,
+                                int pos, rts_time_t w) {
+	rts_time_t sum = 0;
+
+	for (int k = 0; k < pos; k++) {
+		const struct rts_task *t = &tasks[order[k]];
+		sum += rta_ceil_div(w, t->period) * t->wcet;
+	}
+
+	return sum;
+}
+
+int rts_analysis_rta(const struct rts_task *tasks, int n, const int *order,
+                     rts_time_t *resp) {
+	rts_time_t prev = 0;
+	int misses = 0;
+
+	for (int pos = 0; pos < n; pos++) {
+		const struct rts_task *ti = &tasks[order[pos]];
+		rts_time_t worst = 0;
+
+		/*
+		 * The first job of task i completes after the whole level-(i-1)
+		 * busy period, so R(i-1) + C(i) is a valid starting point.
+		 */
+		rts_time_t w = prev + ti->wcet;
+
+		for (int q = 0; ; q++) {
+			rts_time_t r;
+
+			/* Least fixed point of w = (q + 1) * C + hp(w) */
+			for (;;) {
+				rts_time_t next = (q + 1) * (rts_time_t)ti->wcet +
+				                  rta_hp_demand(tasks, order, pos, w);
+				if (next == w)
+					break;
+				w = next;
+				if (w - q * (rts_time_t)ti->period > ti->rel_deadline)
+					break;
+			}
+
+			r = w - q * (rts_time_t)ti->period;
+			worst = rts_max_i64(worst, r);
+			if (r > ti->rel_deadline)
+				break;
+
+			/* Busy period over before job q + 1 is released */
+			if (w <= (q + 1) * (rts_time_t)ti->period)
+				break;
+
+			/* Job q + 1 finishes at least C later than job q */
+			w += ti->wcet;
+		}
+
+		resp[order[pos]] = worst;
+		if (worst > ti->rel_deadline)
+			misses++;
+		prev = worst;
+	}
+
+	return misses;
+}
+
+/**
+ * pt_saturated - whether the tasks ranked at or above @pos use the whole
+ * processor, so that their level-@pos busy period need not end
+ *
+ * Exact while the hyperperiod of their periods fits in 64 bits; beyond
+ * that, a utilization within rounding of 1 counts as saturated.
+ */
+static int pt_saturated(const struct rts_task *tasks, const int *order, int pos) {
+	int64_t hp = 1;
+	int k;
+
+	for (k = 0; k <= pos; k++) {
+		if (rts_util_lcm(hp, tasks[order[k]].period, &hp) != 0)
+			break;
+	}
+
+	if (k > pos) {
+		int64_t sum = 0;
+
+		for (k = 0; k <= pos; k++) {
+			const struct rts_task *t = &tasks[order[k]];
+			int64_t share = hp / t->period;
+
+			if (share > (hp - sum) / t->wcet)
+				return 1;
+			sum += share * t->wcet;
+		}
+		return sum >= hp;
+	}
+
+	long double u = 0.0L;
+	for (k = 0; k <= pos; k++)
+		u += (long double)tasks[order[k]].wcet / tasks[order[k]].period;
+	return u >= 1.0L - 1e-12L;
+}
+
+/**
+ * pt_response - worst-case response time of the task at @pos when it is
+ * blocked for @block and, once started, preempted only by tasks ranked
+ * above position @th
+ *
+ * Deferred-preemption RTA (Bril et al.): the level-@pos busy period is
+ * the blocking plus all work ranked at or above @pos, and every job of
+ * the task released in it is examined, since higher-ranked jobs released
+ * while one runs unpreempted keep the busy period going past its period.
+ * A saturated level is reported as a miss.  As in rts_analysis_rta(),
+ * the iteration stops once the task misses its deadline.
+ */
+static rts_time_t pt_response(const struct rts_task *tasks, const int *order,
+                              int pos, int th, rts_time_t block) {
+	const struct rts_task *ti = &tasks[order[pos]];
+	rts_time_t c = ti->wcet, t = ti->period, d = ti->rel_deadline;
+	rts_time_t len = block + c, s = 0, worst = 0;
+
+	if (pt_saturated(tasks, order, pos))
+		return d + 1;
+
+	/* Least fixed point of L = B + sum over ranks <= pos of ceil(L / T) * C */
+	for (;;) {
+		rts_time_t next = block + rta_hp_demand(tasks, order, pos + 1, len);
+		if (next == len)
+			break;
+		len = next;
+	}
+
+	rts_time_t jobs = rta_ceil_div(len, t);
+
+	for (rts_time_t q = 0; q < jobs; q++) {
+		/*
+		 * Job q starts once the blocking, the q earlier jobs and every
+		 * higher-ranked job released up to that instant are served.
+		 */
+		s = rts_max_i64(s, block + q * c);
+		while (s - q * t + c <= d) {
+			rts_time_t next = block + q * c + rta_hp_demand(tasks, order, pos, s + 1);
+			if (next == s)
+				break;
+			s = next;
+		}
+
+		/* From then on only jobs ranked above the threshold interfere */
+		rts_time_t f = s + c;
+		while (f - q * t <= d) {
+			rts_time_t next = s + c + rta_hp_demand(tasks, order, th, f) -
+			                  rta_hp_demand(tasks, order, th, s + 1);
+			if (next == f)
+				break;
+			f = next;
+		}
+
+		rts_time_t r = f - q * t;
+		worst = rts_max_i64(worst, r);
+		if (r > d)
+			break;
+	}
+
+	return worst;
+}
+
+/**
+ * pt_blocking - longest time a lower-ranked job that @pos cannot preempt
+ * may still hold the processor when a job of @pos is released
+ *
+ * Such a job started at least one time unit earlier, hence C - 1.
+ */
+static rts_time_t pt_blocking(const struct rts_task *tasks, int n, const int *order,
+                              const int *thresh, int pos) {
+	rts_time_t block = 0;
+
+	for (int k = pos + 1; k < n; k++) {
+		if (thresh[order[k]] <= pos)
+			block = rts_max_i64(block, tasks[order[k]].wcet - 1);
+	}
+
+	return block;
+}
+
+int rts_analysis_rta_pt(const struct rts_task *tasks, int n, const int *order,
+                        const int *thresh, rts_time_t *resp) {
+	int misses = 0;
+
+	for (int pos = 0; pos < n; pos++) {
+		const struct rts_task *ti = &tasks[order[pos]];
+		rts_time_t block = pt_blocking(tasks, n, order, thresh, pos);
+		rts_time_t r = pt_response(tasks, order, pos, thresh[order[pos]], block);
+
+		resp[order[pos]] = r;
+		if (r > ti->rel_deadline)
+			misses++;
+	}
+
+	return misses;
+}
+
+/**
+ * pt_tolerance - longest blocking the fully preemptive task at @pos takes
+ * without missing its deadline, or -1 if it misses even unblocked
+ */
+static rts_time_t pt_tolerance(const struct rts_task *tasks, const int *order, int pos) {
+	const struct rts_task *ti = &tasks[order[pos]];
+	rts_time_t lo = 0, hi = (rts_time_t)ti->rel_deadline - ti->wcet;
+
+	if (hi < 0 || pt_response(tasks, order, pos, pos, 0) > ti->rel_deadline)
+		return -1;
+
+	/* Response times grow with the blocking; keep lo feasible */
+	while (lo < hi) {
+		rts_time_t mid = lo + (hi - lo + 1) / 2;
+
+		if (pt_response(tasks, order, pos, pos, mid) <= ti->rel_deadline)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+
+	return lo;
+}
+
+int rts_analysis_pt_assign(const struct rts_task *tasks, int n, const int *order,
+                           int *thresh) {
+	rts_time_t *tol = malloc(sizeof(*tol) * (size_t)(n > 0 ? n : 1));
+	if (!tol)
+		return -1;
+
+	for (int pos = 0; pos < n; pos++)
+		tol[pos] = pt_tolerance(tasks, order, pos);
+
+	for (int pos = 0; pos < n; pos++) {
+		rts_time_t c = tasks[order[pos]].wcet - 1;
+		int th = pos;
+
+		while (th > 0 && c <= tol[th - 1])
+			th--;
+		thresh[order[pos]] = th;
+	}
+
+	free(tol);
+	return 0;
+}
+
+static int rm_order_cmp(const void *pa, const void *pb) {
+	const struct rts_task *a = *(const struct rts_task *const *)pa;
+	const struct rts_task *b = *(const struct rts_task *const *)pb;
+
+	if (a->period != b->period)
+		return a->period < b->period ? -1 : 1;
+	return a->tid < b->tid ? -1 : (a->tid > b->tid);
+}
+
+int rts_analysis_rm_order(const struct rts_task *tasks, int n, int *order) {
+	const struct rts_task **by_prio = malloc(sizeof(*by_prio) * (size_t)(n > 0 ? n : 1));
+	if (!by_prio)
+		return -1;
+
+	for (int i = 0; i < n; i++)
+		by_prio[i] = &tasks[i];
+	qsort(by_prio, (size_t)n, sizeof(*by_prio), rm_order_cmp);
+	for (int i = 0; i < n; i++)
+		order[i] = (int)(by_prio[i] - tasks);
+
+	free(by_prio);
+	return 0;
+}
+
+/* Largest bound QPA accepts; keeps every demand sum below RTS_TIME_MAX */
+#define QPA_BOUND_MAX (RTS_TIME_MAX / 4)
+
+/**
+ * qpa_demand - h(@t), the work of all jobs with deadline in [0, @t]
+ */
+static rts_time_t qpa_demand(const struct rts_task *tasks, int n, rts_time_t t) {
+	rts_time_t sum = 0;
+
+	for (int i = 0; i < n; i++) {
+		const struct rts_task *ti = &tasks[i];
+
+		if (t >= ti->rel_deadline)
+			sum += ((t - ti->rel_deadline) / ti->period + 1) * ti->wcet;
+	}
+
+	return sum;
+}
+
+/**
+ * qpa_prev_deadline - latest absolute deadline strictly before @t, or -1
+ */
+static rts_time_t qpa_prev_deadline(const struct rts_task *tasks, int n, rts_time_t t) {
+	rts_time_t best = -1;
+
+	for (int i = 0; i < n; i++) {
+		const struct rts_task *ti = &tasks[i];
+
+		if (ti->rel_deadline >= t)
+			continue;
+		rts_time_t d = ti->rel_deadline +
+		               (t - 1 - ti->rel_deadline) / ti->period * ti->period;
+		best = rts_max_i64(best, d);
+	}
+
+	return best;
+}
+
+/**
+ * qpa_util_cmp - compare the utilization of @tasks with 1
+ *
+ * Exact while the hyperperiod fits in 64 bits.  Returns <0, 0 or >0.
+ */
+static int qpa_util_cmp(const struct rts_task *tasks, int n) {
+	int *periods = malloc(sizeof(*periods) * (size_t)n);
+	int64_t hp;
+
+	if (periods) {
+		for (int i = 0; i < n; i++)
+			periods[i] = tasks[i].period;
+
+		if (rts_util_hyperperiod(periods, n, &hp) == 0) {
+			int64_t sum = 0;
+
+			free(periods);
+			for (int i = 0; i < n; i++) {
+				int64_t share = hp / tasks[i].period;
+
+				if (share > (hp - sum) / tasks[i].wcet)
+					return 1;
+				sum += share * tasks[i].wcet;
+			}
+			return sum < hp ? -1 : 0;
+		}
+		free(periods);
+	}
+
+	long double u = 0.0L;
+	for (int i = 0; i < n; i++)
+		u += (long double)tasks[i].wcet / tasks[i].period;
+	return u < 1.0L ? -1 : (u > 1.0L);
+}
+
+/**
+ * qpa_busy_period - length of the synchronous busy period
+ *
+ * Only called with utilization at most 1, where the iteration converges.
+ * Returns -1 if it grows beyond QPA_BOUND_MAX.
+ */
+static rts_time_t qpa_busy_period(const struct rts_task *tasks, int n) {
+	rts_time_t w = 0;
+
+	for (int i = 0; i < n; i++)
+		w += tasks[i].wcet;
+
+	for (;;) {
+		rts_time_t next = 0;
+
+		for (int i = 0; i < n; i++)
+			next += rta_ceil_div(w, tasks[i].period) * tasks[i].wcet;
+		if (next == w)
+			return w;
+		if (next > QPA_BOUND_MAX)
+			return -1;
+		w = next;
+	}
+}
+
+/**
+ * qpa_search - look for a violation at or below @t
+ *
+ * Returns some t' in [dmin, @t] with h(t') > t', or -1 if there is none.
+ */
+static rts_time_t qpa_search(const struct rts_task *tasks, int n, rts_time_t t,
+                             rts_time_t dmin, long *points) {
+	while (t >= dmin) {
+		rts_time_t h = qpa_demand(tasks, n, t);
+
+		(*points)++;
+		if (h > t)
+			return t;
+		if (h <= dmin)
+			return -1;
+		t = h < t ? h : qpa_prev_deadline(tasks, n, t);
+	}
+
+	return -1;
+}
+
+int rts_analysis_qpa(const struct rts_task *tasks, int n,
+                     struct rts_analysis_dbf *res) {
+	*res = (struct rts_analysis_dbf){ .fail_at = -1 };
+
+	if (n <= 0)
+		return 1;
+
+	int cmp = qpa_util_cmp(tasks, n);
+	if (cmp > 0) {
+		res->util_over = 1;
+		return 0;
+	}
+
+	rts_time_t bound = qpa_busy_period(tasks, n);
+	if (bound < 0)
+		return -1;
+
+	rts_time_t dmin = tasks[0].rel_deadline;
+	rts_time_t dmax = tasks[0].rel_deadline;
+	for (int i = 1; i < n; i++) {
+		dmin = rts_min_i64(dmin, tasks[i].rel_deadline);
+		dmax = rts_max_i64(dmax, tasks[i].rel_deadline);
+	}
+
+	/* Zhang & Burns: no first violation beyond La when U < 1 */
+	if (cmp < 0) {
+		long double u = 0.0L, slack = 0.0L;
+
+		for (int i = 0; i < n; i++) {
+			long double ui = (long double)tasks[i].wcet / tasks[i].period;
+
+			u += ui;
+			slack += (tasks[i].period - tasks[i].rel_deadline) * ui;
+		}
+
+		long double la = u < 1.0L ? slack / (1.0L - u) : (long double)bound;
+		if (la < (long double)dmax)
+			la = (long double)dmax;
+		if (la < (long double)bound)
+			bound = (rts_time_t)ceill(la);
+	}
+	res->bound = bound;
+
+	rts_time_t fail = qpa_search(tasks, n, qpa_prev_deadline(tasks, n, bound + 1),
+	                             dmin, &res->points);
+	if (fail < 0)
+		return 1;
+
+	/* QPA finds some violation; keep searching below it for the first */
+	for (;;) {
+		rts_time_t prev = qpa_search(tasks, n, qpa_prev_deadline(tasks, n, fail),
+		                             dmin, &res->points);
+		if (prev < 0)
+			break;
+		fail = prev;
+	}
+
+	res->fail_at = fail;
+	res->demand = qpa_demand(tasks, n, fail);
+	return 0;
+}
@@ -17,6 +17,9 @@
 extern const struct rts_sched_class rts_sched_rm;
 extern const struct rts_sched_class rts_sched_edf;
 extern const struct rts_sched_class rts_sched_lst;
+extern const struct rts_sched_class rts_sched_np_rm;
+extern const struct rts_sched_class rts_sched_np_edf;
+extern const struct rts_sched_class rts_sched_rm_pt;
 
 /**
  * Scheduler Registry Table
@@ -26,10 +29,17 @@ static const struct rts_sched_class * const available_schedulers[] = {
     &rts_sched_rm,
     &rts_sched_edf,
     &rts_sched_lst,
+    &rts_sched_np_rm,
+    &rts_sched_np_edf,
+    &rts_sched_rm_pt,
     // &rts_sched_rr,
     NULL
 };
 
+const struct rts_sched_class * const *rts_sched_list(void) {
+    return available_schedulers;
+}
+
 const struct rts_sched_class *rts_sched_from_name(const char *name) {
     if (!name || !*name) {
         fprintf(stderr, "Error: scheduler name is empty\n");
@@ -59,9 +69,13 @@ const struct rts_sched_class *rts_sched_from_name(const char *name) {
 
 /**
  * rts_sched_default_enqueue - generic ordered enqueue
+ *
+ * The ready queue was bound to @sched by rts_rq_setup() and orders the job
+ * with its backend.
  */
 void rts_sched_default_enqueue(struct rts_sim *sim,
                                struct rts_job *job,
                                const struct rts_sched_class *sched) {
-	rts_rq_ordered_insert(&sim->ready_queue, job, sched, sim->tasks, sim->clock);
+	(void)sched;
+	rts_rq_insert(&sim->ready_queue, job);
 }
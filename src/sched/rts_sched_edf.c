@@ -3,10 +3,12 @@
  * @file rts_sched_edf.c
  * @brief Earliest Deadline First (EDF) scheduling class.
  */
+#include "rts_analysis.h"
 #include "rts_sched.h"
 #include "rts_types.h"
 #include "rts_util.h"
 
+#include <inttypes.h>
 #include <stdio.h>
 
 /**
@@ -21,27 +23,61 @@
 static int edf_higher_prio(const struct rts_job *a,
                            const struct rts_job *b,
                            const struct rts_task *tasks,
-                           int now) {
-	(void)tasks;
-	(void)now;
-
-	// Tie-breaker: lower TID
-	if (a->abs_deadline == b->abs_deadline)
-		return a->tid < b->tid;
-	
-	return a->abs_deadline < b->abs_deadline;
+                           rts_time_t now) {
+	return rts_prio_edf(a, b, tasks, now);
 }
 
-static int edf_schedulability_test(const struct rts_task *tasks, int n) {
+/**
+ * edf_analyze - exact processor-demand analysis under EDF
+ *
+ * Reports the first interval [0, t] whose demand exceeds its length.
+ */
+static int edf_analyze(const struct rts_task *tasks, int n, FILE *out) {
+	struct rts_analysis_dbf res;
+	int ok = rts_analysis_qpa(tasks, n, &res);
+
+	if (ok < 0) {
+		fprintf(stderr, "[EDF] demand bound exceeds the 64-bit time range\n");
+		return 0;
+	}
+
+	if (out) {
+		if (res.util_over) {
+			fprintf(out, "[EDF] Processor-demand analysis: U > 1, demand outgrows every interval\n");
+		} else {
+			fprintf(out, "[EDF] Processor-demand analysis (QPA) up to L=%" PRId64
+			        ", %ld points checked\n", res.bound, res.points);
+			if (res.fail_at >= 0)
+				fprintf(out, "  first violation: h(%" PRId64 ")=%" PRId64
+				        " > %" PRId64 " in [0, %" PRId64 "]\n",
+				        res.fail_at, res.demand, res.fail_at, res.fail_at);
+		}
+		fprintf(out, "[EDF] QPA → %s\n", ok ? "Schedulable" : "Unschedulable");
+	}
+
+	return ok;
+}
+
+static int edf_schedulability_test(const struct rts_task *tasks, int n, FILE *out) {
 	double U = 0.0;
 
 	for (int i = 0; i < n; i++) {
 		int denom = rts_min_int(tasks[i].period, tasks[i].rel_deadline);
 		U += (double)tasks[i].wcet / denom;
 	}
-	printf("[EDF] U=%.3f → %s\n", U, (U <= 1.0) ? "Schedulable" : "Unschedulable");
-	
-	return U <= 1.0;
+
+	if (U <= 1.0) {
+		if (out)
+			fprintf(out, "[EDF] U=%.3f → Schedulable\n", U);
+		return 1;
+	}
+
+	/* The density test is only sufficient; settle it exactly */
+	int ok = edf_analyze(tasks, n, NULL);
+	if (out)
+		fprintf(out, "[EDF] U=%.3f, QPA → %s\n", U, ok ? "Schedulable" : "Unschedulable");
+
+	return ok;
 }
 
 /* Scheduler class */
@@ -51,4 +87,8 @@ const struct rts_sched_class rts_sched_edf = {
     .enqueue = NULL,
     .tick = NULL,
     .schedulability_test = edf_schedulability_test,
+    .analyze = edf_analyze,
+    .preempt_at = NULL,
+    .rq_ops = NULL,
+    .prio = RTS_PRIO_EDF,
 };
@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_sched_lp.c
+ * @brief Limited-preemption variants of RM and EDF.
+ *
+ * NP-RM and NP-EDF never preempt: once a job has started it runs to
+ * completion.  RM-PT gives every task a preemption threshold at or above
+ * its RM priority, so a started job can only be preempted by tasks ranked
+ * above its threshold.  All three are orders on the ready queue (see
+ * rts_prio_np_rm() etc.), so they run under every engine and backend and
+ * in global mode.
+ */
+#include "rts_analysis.h"
+#include "rts_sched.h"
+#include "rts_types.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int np_rm_higher_prio(const struct rts_job *a,
+                             const struct rts_job *b,
+                             const struct rts_task *tasks,
+                             rts_time_t now) {
+	return rts_prio_np_rm(a, b, tasks, now);
+}
+
+static int np_edf_higher_prio(const struct rts_job *a,
+                              const struct rts_job *b,
+                              const struct rts_task *tasks,
+                              rts_time_t now) {
+	return rts_prio_np_edf(a, b, tasks, now);
+}
+
+static int rm_pt_higher_prio(const struct rts_job *a,
+                             const struct rts_job *b,
+                             const struct rts_task *tasks,
+                             rts_time_t now) {
+	return rts_prio_rm_pt(a, b, tasks, now);
+}
+
+/**
+ * lp_rm_test - RTA under RM priorities with the thresholds RM-PT would
+ * assign (@pt) or none at all, i.e. non-preemptive
+ *
+ * Prints every task's threshold and response time to @out if @verbose.
+ */
+static int lp_rm_test(const char *name, const struct rts_task *tasks, int n,
+                      int pt, int verbose, FILE *out) {
+	int *order = malloc(sizeof(*order) * (n > 0 ? n : 1));
+	int *thresh = calloc((size_t)(n > 0 ? n : 1), sizeof(*thresh));
+	rts_time_t *resp = malloc(sizeof(*resp) * (n > 0 ? n : 1));
+
+	if (!order || !thresh || !resp || rts_analysis_rm_order(tasks, n, order) != 0 ||
+	    (pt && rts_analysis_pt_assign(tasks, n, order, thresh) != 0)) {
+		fprintf(stderr, "[%s] out of memory for response-time analysis\n", name);
+		free(resp);
+		free(thresh);
+		free(order);
+		return 0;
+	}
+
+	int misses = rts_analysis_rta_pt(tasks, n, order, thresh, resp);
+
+	if (out && verbose) {
+		fprintf(out, "[%s] Response-time analysis (highest priority first):\n", name);
+		for (int k = 0; k < n; k++) {
+			const struct rts_task *t = &tasks[order[k]];
+			int late = resp[order[k]] > t->rel_deadline;
+
+			fprintf(out, "  T%d: C=%d T=%d D=%d rank=%d threshold=%d R%s%" PRId64 " %s\n",
+			        t->tid + 1, t->wcet, t->period, t->rel_deadline,
+			        k + 1, thresh[order[k]] + 1,
+			        late ? ">" : "=", resp[order[k]], late ? "MISS" : "ok");
+		}
+	}
+	if (out)
+		fprintf(out, "[%s] RTA with blocking → %s\n", name,
+		        misses ? "Unschedulable" : "Schedulable");
+
+	free(resp);
+	free(thresh);
+	free(order);
+	return misses == 0;
+}
+
+static int np_rm_schedulability_test(const struct rts_task *tasks, int n, FILE *out) {
+	return lp_rm_test("NP-RM", tasks, n, 0, 0, out);
+}
+
+static int rm_pt_schedulability_test(const struct rts_task *tasks, int n, FILE *out) {
+	return lp_rm_test("RM-PT", tasks, n, 1, 1, out);
+}
+
+static int np_edf_schedulability_test(const struct rts_task *tasks, int n, FILE *out) {
+	(void)tasks;
+	(void)n;
+
+	if (out)
+		fprintf(out, "[NP-EDF] No analytic schedulability test; run simulation.\n");
+	return 1;
+}
+
+/**
+ * rm_pt_prepare - rank the tasks by RM and give each the highest
+ * threshold rts_analysis_pt_assign() allows
+ */
+static int rm_pt_prepare(struct rts_task *tasks, int n) {
+	int *order = malloc(sizeof(*order) * (n > 0 ? n : 1));
+	int *thresh = malloc(sizeof(*thresh) * (n > 0 ? n : 1));
+
+	if (!order || !thresh || rts_analysis_rm_order(tasks, n, order) != 0 ||
+	    rts_analysis_pt_assign(tasks, n, order, thresh) != 0) {
+		free(thresh);
+		free(order);
+		return -1;
+	}
+
+	for (int k = 0; k < n; k++) {
+		tasks[order[k]].pt_rank = k;
+		tasks[order[k]].pt_threshold = thresh[order[k]];
+	}
+
+	free(thresh);
+	free(order);
+	return 0;
+}
+
+const struct rts_sched_class rts_sched_np_rm = {
+    .name = "NP-RM",
+    .higher_prio = np_rm_higher_prio,
+    .enqueue = NULL,
+    .tick = NULL,
+    .schedulability_test = np_rm_schedulability_test,
+    .analyze = NULL,
+    .preempt_at = NULL,
+    .prepare = NULL,
+    .rq_ops = NULL,
+    .prio = RTS_PRIO_NP_RM,
+};
+
+const struct rts_sched_class rts_sched_np_edf = {
+    .name = "NP-EDF",
+    .higher_prio = np_edf_higher_prio,
+    .enqueue = NULL,
+    .tick = NULL,
+    .schedulability_test = np_edf_schedulability_test,
+    .analyze = NULL,
+    .preempt_at = NULL,
+    .prepare = NULL,
+    .rq_ops = NULL,
+    .prio = RTS_PRIO_NP_EDF,
+};
+
+const struct rts_sched_class rts_sched_rm_pt = {
+    .name = "RM-PT",
+    .higher_prio = rm_pt_higher_prio,
+    .enqueue = NULL,
+    .tick = NULL,
+    .schedulability_test = rm_pt_schedulability_test,
+    .analyze = NULL,
+    .preempt_at = NULL,
+    .prepare = rm_pt_prepare,
+    .rq_ops = NULL,
+    .prio = RTS_PRIO_RM_PT,
+};
@@ -3,6 +3,7 @@
  * @file rts_sched_lst.c
  * @brief Implementation of Least Slack Time (LST) scheduling policy.
  */
+#include "rts_rq.h"
 #include "rts_sched.h"
 #include "rts_types.h"
 
@@ -11,24 +12,38 @@
 static int lst_higher_prio(const struct rts_job *a,
                            const struct rts_job *b,
                            const struct rts_task *tasks,
-                           int now) {
+                           rts_time_t now) {
+	return rts_prio_lst(a, b, tasks, now);
+}
+
+/**
+ * lst_preempt_at - when a waiting job may overtake the running one
+ *
+ * The running job's slack stays constant while it executes, whereas a
+ * waiting job w loses one unit of slack per tick, so their slacks are
+ * equal at abs_deadline(w) - remain(w) - slack(cur).  That key is the
+ * deadline index's, so the earliest such time over the queue is read off
+ * its top.  Ties are resolved by TID (and list order), so report that
+ * point conservatively and let the engine re-evaluate.
+ */
+static rts_time_t lst_preempt_at(const struct rts_job *cur,
+                                 const struct rts_rq *rq,
+                                 const struct rts_task *tasks,
+                                 rts_time_t now) {
 	(void)tasks;
 
-	int slack_a = a->abs_deadline - now - a->remain;
-	int slack_b = b->abs_deadline - now - b->remain;
+	rts_time_t slack_cur = cur->abs_deadline - now - cur->remain;
+	rts_time_t lfs = rts_rq_dl_next(rq, cur);
 
-	// Tie-breaker: lower TID
-	if (slack_a == slack_b)
-		return a->tid < b->tid;
-	
-	return slack_a < slack_b;
+	return lfs == RTS_TIME_MAX ? RTS_TIME_MAX : lfs - slack_cur;
 }
 
-static int lst_schedulability_test(const struct rts_task *tasks, int n) {
+static int lst_schedulability_test(const struct rts_task *tasks, int n, FILE *out) {
 	(void)tasks;
 	(void)n;
 
-	printf("[LST] No analytic schedulability test; run simulation.\n");
+	if (out)
+		fprintf(out, "[LST] No analytic schedulability test; run simulation.\n");
 	return 1;
 }
 
@@ -38,4 +53,8 @@ const struct rts_sched_class rts_sched_lst = {
     .enqueue = NULL,
     .tick = NULL,
     .schedulability_test = lst_schedulability_test,
+    .analyze = NULL,
+    .preempt_at = lst_preempt_at,
+    .rq_ops = &rts_rq_lst_ops,
+    .prio = RTS_PRIO_LST,
 };
@@ -3,27 +3,61 @@
  * @file rts_sched_rm.c
  * @brief Implementation of Rate Monotonic (RM) scheduling policy.
  */
+#include "rts_analysis.h"
 #include "rts_sched.h"
 #include "rts_types.h"
 #include "rts_util.h"
 
+#include <inttypes.h>
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 static int rm_higher_prio(const struct rts_job *a,
                           const struct rts_job *b,
                           const struct rts_task *tasks,
-                          int now) {
-	(void)now;
+                          rts_time_t now) {
+	return rts_prio_rm(a, b, tasks, now);
+}
+
+/**
+ * rm_analyze - exact response-time analysis under RM priorities
+ *
+ * Priorities follow rm_higher_prio(): shorter period first, then lower
+ * TID.
+ */
+static int rm_analyze(const struct rts_task *tasks, int n, FILE *out) {
+	int *order = malloc(sizeof(*order) * (n > 0 ? n : 1));
+	rts_time_t *resp = malloc(sizeof(*resp) * (n > 0 ? n : 1));
+
+	if (!order || !resp || rts_analysis_rm_order(tasks, n, order) != 0) {
+		fprintf(stderr, "[RM] out of memory for response-time analysis\n");
+		free(resp);
+		free(order);
+		return 0;
+	}
+
+	int misses = rts_analysis_rta(tasks, n, order, resp);
 
-	// Tie-breaker: lower TID
-	if (tasks[a->tid].period == tasks[b->tid].period)
-		return a->tid < b->tid;
+	if (out) {
+		fprintf(out, "[RM] Response-time analysis (highest priority first):\n");
+		for (int k = 0; k < n; k++) {
+			const struct rts_task *t = &tasks[order[k]];
+			int late = resp[order[k]] > t->rel_deadline;
 
-	return tasks[a->tid].period < tasks[b->tid].period;
+			fprintf(out, "  T%d: C=%d T=%d D=%d R%s%" PRId64 " %s\n",
+			        t->tid + 1, t->wcet, t->period, t->rel_deadline,
+			        late ? ">" : "=", resp[order[k]], late ? "MISS" : "ok");
+		}
+		fprintf(out, "[RM] RTA → %s\n", misses ? "Unschedulable" : "Schedulable");
+	}
+
+	free(resp);
+	free(order);
+	return misses == 0;
 }
 
-static int rm_schedulability_test(const struct rts_task *tasks, int n) {
+static int rm_schedulability_test(const struct rts_task *tasks, int n, FILE *out) {
 	double U = 0.0;
 
 	for (int i = 0; i < n; i++) {
@@ -31,9 +65,20 @@ static int rm_schedulability_test(const struct rts_task *tasks, int n) {
 		U += (double)tasks[i].wcet / denom;
 	}
 	double bound = n * (pow(2.0, 1.0 / n) - 1.0);
-	printf("[RM] U=%.3f bound=%.3f → %s\n", U, bound, (U <= bound) ? "Schedulable" : "Unschedulable");
-	
-	return U <= bound;
+
+	if (U <= bound) {
+		if (out)
+			fprintf(out, "[RM] U=%.3f bound=%.3f → Schedulable\n", U, bound);
+		return 1;
+	}
+
+	/* The bound is only sufficient; settle it exactly */
+	int ok = rm_analyze(tasks, n, NULL);
+	if (out)
+		fprintf(out, "[RM] U=%.3f bound=%.3f, RTA → %s\n", U, bound,
+		        ok ? "Schedulable" : "Unschedulable");
+
+	return ok;
 }
 
 const struct rts_sched_class rts_sched_rm = {
@@ -42,4 +87,8 @@ const struct rts_sched_class rts_sched_rm = {
     .enqueue = NULL,
     .tick = NULL,
     .schedulability_test = rm_schedulability_test,
+    .analyze = rm_analyze,
+    .preempt_at = NULL,
+    .rq_ops = NULL,
+    .prio = RTS_PRIO_RM,
 };
@@ -0,0 +1,397 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_gen.c
+ * @brief Synthetic task set generator.
+ */
+#include "rts_gen.h"
+#include "rts_types.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* UUniFast-discard gives up after this many rejected splits */
+#define RTS_GEN_MAX_TRIES 10000
+
+/* WCET units per period for an average utilization share */
+#define RTS_GEN_MIN_UNITS 2
+
+/* Largest relative error of the rounded utilization against the request */
+#define RTS_GEN_UTIL_TOL 0.05
+
+/**
+ * struct rts_gen_rng - xoshiro256** state, seeded through splitmix64
+ */
+struct rts_gen_rng {
+	uint64_t s[4];
+};
+
+static uint64_t rts_gen_splitmix(uint64_t *x) {
+	uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+static void rts_gen_seed(struct rts_gen_rng *rng, uint64_t seed) {
+	for (int i = 0; i < 4; i++)
+		rng->s[i] = rts_gen_splitmix(&seed);
+}
+
+static inline uint64_t rts_gen_rotl(uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t rts_gen_next(struct rts_gen_rng *rng) {
+	uint64_t *s = rng->s;
+	uint64_t out = rts_gen_rotl(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rts_gen_rotl(s[3], 45);
+
+	return out;
+}
+
+/* Uniform in [0, 1) */
+static double rts_gen_uniform(struct rts_gen_rng *rng) {
+	return (double)(rts_gen_next(rng) >> 11) * 0x1.0p-53;
+}
+
+/* Uniform integer in [lo, hi] */
+static int rts_gen_range(struct rts_gen_rng *rng, int lo, int hi) {
+	return lo + (int)(rts_gen_uniform(rng) * ((double)hi - lo + 1));
+}
+
+void rts_gen_defaults(struct rts_gen_opts *opts) {
+	*opts = (struct rts_gen_opts){
+	    .n_tasks = 10,
+	    .util = 0.7,
+	    .discard = 0,
+	    .periods = RTS_GEN_LOGUNIFORM,
+	    .tmin = 30,
+	    .tmax = 1000,
+	    .constrained = 0,
+	    .phased = 0,
+	    .seed = 1,
+	};
+}
+
+static int rts_gen_parse_int(const char *val, int *out) {
+	char *end;
+	long v = strtol(val, &end, 10);
+
+	if (end == val || *end || v < 0 || v > 0x7fffffffL)
+		return -1;
+	*out = (int)v;
+	return 0;
+}
+
+static int rts_gen_set(struct rts_gen_opts *opts, const char *key, const char *val) {
+	if (strcmp(key, "n") == 0)
+		return rts_gen_parse_int(val, &opts->n_tasks);
+	if (strcmp(key, "tmin") == 0)
+		return rts_gen_parse_int(val, &opts->tmin);
+	if (strcmp(key, "tmax") == 0)
+		return rts_gen_parse_int(val, &opts->tmax);
+	if (strcmp(key, "phased") == 0)
+		return rts_gen_parse_int(val, &opts->phased);
+
+	if (strcmp(key, "u") == 0) {
+		char *end;
+
+		opts->util = strtod(val, &end);
+		return (end == val || *end || !(opts->util > 0.0)) ? -1 : 0;
+	}
+
+	if (strcmp(key, "seed") == 0) {
+		char *end;
+
+		opts->seed = strtoull(val, &end, 0);
+		return (end == val || *end) ? -1 : 0;
+	}
+
+	if (strcmp(key, "split") == 0) {
+		if (strcmp(val, "uunifast") == 0)
+			opts->discard = 0;
+		else if (strcmp(val, "discard") == 0)
+			opts->discard = 1;
+		else
+			return -1;
+		return 0;
+	}
+
+	if (strcmp(key, "periods") == 0) {
+		if (strcmp(val, "loguniform") == 0)
+			opts->periods = RTS_GEN_LOGUNIFORM;
+		else if (strcmp(val, "harmonic") == 0)
+			opts->periods = RTS_GEN_HARMONIC;
+		else if (strcmp(val, "divisor") == 0)
+			opts->periods = RTS_GEN_DIVISOR;
+		else
+			return -1;
+		return 0;
+	}
+
+	if (strcmp(key, "deadlines") == 0) {
+		if (strcmp(val, "implicit") == 0)
+			opts->constrained = 0;
+		else if (strcmp(val, "constrained") == 0)
+			opts->constrained = 1;
+		else
+			return -1;
+		return 0;
+	}
+
+	return -1;
+}
+
+int rts_gen_parse(struct rts_gen_opts *opts, const char *spec) {
+	const char *p = spec;
+
+	while (*p) {
+		char item[128];
+		size_t len = strcspn(p, ",");
+
+		snprintf(item, sizeof(item), "%.*s", (int)len, p);
+
+		char *eq = strchr(item, '=');
+		if (!eq || rts_gen_set(opts, item, (*eq = '\0', eq + 1)) != 0) {
+			fprintf(stderr, "[gen] bad parameter '%.*s'\n", (int)len, p);
+			return -1;
+		}
+
+		p += len;
+		if (*p == ',')
+			p++;
+	}
+
+	return 0;
+}
+
+/**
+ * rts_gen_uunifast - split @total over @n tasks
+ *
+ * With @discard, splits giving some task a utilization above 1 are drawn
+ * again.  Returns 0 on success, -1 if no valid split was found.
+ */
+static int rts_gen_uunifast(struct rts_gen_rng *rng, double *u, int n,
+                            double total, int discard) {
+	for (int tries = 0; tries < RTS_GEN_MAX_TRIES; tries++) {
+		double sum = total;
+		int ok = 1;
+
+		for (int i = 0; i < n - 1; i++) {
+			double next = sum * pow(rts_gen_uniform(rng), 1.0 / (n - 1 - i));
+
+			u[i] = sum - next;
+			sum = next;
+			ok &= u[i] <= 1.0;
+		}
+		u[n - 1] = sum;
+		ok &= sum <= 1.0;
+
+		if (ok || !discard)
+			return 0;
+	}
+
+	return -1;
+}
+
+static int rts_gen_int_cmp(const void *pa, const void *pb) {
+	int a = *(const int *)pa, b = *(const int *)pb;
+
+	return (a > b) - (a < b);
+}
+
+/**
+ * rts_gen_divisors - divisors of @base within [@lo, @base], ascending
+ */
+static int *rts_gen_divisors(int base, int lo, int *n_out) {
+	int n = 0, cap = 64;
+	int *d = malloc(sizeof(*d) * cap);
+
+	for (int k = 1; d && (long)k * k <= base; k++) {
+		if (base % k)
+			continue;
+
+		int pair[2] = { k, base / k };
+		for (int j = 0; j < (pair[0] == pair[1] ? 1 : 2); j++) {
+			if (pair[j] < lo)
+				continue;
+			if (n == cap) {
+				int *tmp = realloc(d, sizeof(*d) * (cap *= 2));
+				if (!tmp) {
+					free(d);
+					return NULL;
+				}
+				d = tmp;
+			}
+			d[n++] = pair[j];
+		}
+	}
+
+	if (d)
+		qsort(d, (size_t)n, sizeof(*d), rts_gen_int_cmp);
+	*n_out = n;
+	return d;
+}
+
+/**
+ * rts_gen_period - draw one period
+ * @tmin:   smallest period, at least @opts->tmin
+ * @divs:   allowed periods for RTS_GEN_DIVISOR, ascending
+ * @n_divs: their number
+ *
+ * Divisors are picked by drawing log-uniformly and taking the nearest
+ * one, so their spread resembles the log-uniform case.
+ */
+static int rts_gen_period(struct rts_gen_rng *rng, const struct rts_gen_opts *opts,
+                          int tmin, const int *divs, int n_divs) {
+	double lo = log(tmin), hi = log(opts->tmax);
+
+	switch (opts->periods) {
+	case RTS_GEN_HARMONIC: {
+		int kmax = 0;
+
+		while (((long)tmin << (kmax + 1)) <= opts->tmax)
+			kmax++;
+		return tmin << rts_gen_range(rng, 0, kmax);
+	}
+	case RTS_GEN_DIVISOR: {
+		double x = lo + rts_gen_uniform(rng) * (hi - lo);
+		int best = 0;
+
+		for (int i = 1; i < n_divs; i++) {
+			if (fabs(log(divs[i]) - x) < fabs(log(divs[best]) - x))
+				best = i;
+		}
+		return divs[best];
+	}
+	default: {
+		int t = (int)lround(exp(lo + rts_gen_uniform(rng) * (hi - lo)));
+
+		return t < tmin ? tmin : (t > opts->tmax ? opts->tmax : t);
+	}
+	}
+}
+
+struct rts_task *rts_gen_tasks(const struct rts_gen_opts *opts, int *n_tasks_out) {
+	int n = opts->n_tasks;
+	int tmin = opts->tmin;
+
+	if (n <= 0 || tmin < 1 || opts->tmax < tmin || !(opts->util > 0.0)) {
+		fprintf(stderr, "[gen] need n > 0, u > 0 and 1 <= tmin <= tmax\n");
+		return NULL;
+	}
+
+	/* An average share must come to a few whole units of its period */
+	double tmin_share = ceil(RTS_GEN_MIN_UNITS * n / opts->util);
+	if (tmin_share > tmin) {
+		if (tmin_share > opts->tmax) {
+			fprintf(stderr, "[gen] %d tasks at U=%.3f need periods of at least %.0f\n",
+			        n, opts->util, tmin_share);
+			return NULL;
+		}
+		tmin = (int)tmin_share;
+		fprintf(stderr, "[gen] tmin raised to %d\n", tmin);
+	}
+	if (opts->util > n) {
+		fprintf(stderr, "[gen] utilization %.3f exceeds %d tasks\n", opts->util, n);
+		return NULL;
+	}
+	if (opts->util > 1.0 && !opts->discard) {
+		fprintf(stderr, "[gen] UUniFast needs u <= 1; use split=discard\n");
+		return NULL;
+	}
+
+	int n_divs = 0;
+	int *divs = NULL;
+	if (opts->periods == RTS_GEN_DIVISOR) {
+		divs = rts_gen_divisors(opts->tmax, tmin, &n_divs);
+		if (!divs)
+			return NULL;
+	}
+
+	struct rts_task *tasks = malloc(sizeof(*tasks) * (size_t)n);
+	double *u = malloc(sizeof(*u) * (size_t)n);
+	struct rts_gen_rng rng;
+
+	rts_gen_seed(&rng, opts->seed);
+	if (!tasks || !u)
+		goto fail;
+
+	if (rts_gen_uunifast(&rng, u, n, opts->util, opts->discard) != 0) {
+		fprintf(stderr, "[gen] no UUniFast-discard split after %d tries\n", RTS_GEN_MAX_TRIES);
+		goto fail;
+	}
+
+	/*
+	 * Each WCET also makes up the rounding error of the ones before it,
+	 * so the total stays near the request unless the periods are too
+	 * short for the per-task shares
+	 */
+	double share = 0.0, util = 0.0;
+	for (int i = 0; i < n; i++) {
+		struct rts_task *t = &tasks[i];
+		int period = rts_gen_period(&rng, opts, tmin, divs, n_divs);
+
+		share += u[i];
+		int wcet = (int)lround((share - util) * period);
+
+		if (wcet < 1)
+			wcet = 1;
+		if (wcet > period)
+			wcet = period;
+
+		t->tid = i;
+		t->period = period;
+		t->wcet = wcet;
+		t->rel_deadline = opts->constrained ? rts_gen_range(&rng, wcet, period) : period;
+		t->phase = opts->phased ? rts_gen_range(&rng, 0, period - 1) : 0;
+		t->util = (double)wcet / period;
+		t->release_count = 0;
+		t->next_release = t->phase;
+		t->preemptions = 0;
+		t->migrations = 0;
+		t->pt_rank = 0;
+		t->pt_threshold = 0;
+		util += t->util;
+	}
+
+	/* Shares too small for their periods still round up to one unit */
+	if (fabs(util - opts->util) > RTS_GEN_UTIL_TOL * opts->util) {
+		fprintf(stderr, "[gen] whole-unit WCETs give U=%.4f for requested %.4f\n",
+		        util, opts->util);
+		goto fail;
+	}
+
+	free(u);
+	free(divs);
+	*n_tasks_out = n;
+	return tasks;
+
+fail:
+	free(u);
+	free(tasks);
+	free(divs);
+	return NULL;
+}
+
+int rts_gen_write(FILE *fp, const struct rts_task *tasks, int n_tasks) {
+	fprintf(fp, "# phase, period, deadline, wcet\n");
+
+	for (int i = 0; i < n_tasks; i++) {
+		const struct rts_task *t = &tasks[i];
+
+		fprintf(fp, "%d, %d, %d, %d\n", t->phase, t->period, t->rel_deadline, t->wcet);
+	}
+
+	return ferror(fp) ? -1 : 0;
+}
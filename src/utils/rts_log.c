@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file rts_log.c
+ * @brief Console log sink with an optional asynchronous writer thread.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "rts_log.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RTS_LOG_RING_SIZE  (1u << 20)	/* bytes, power of two */
+#define RTS_LOG_REC_MAX    1024		/* records longer than this are heap formatted */
+#define RTS_LOG_IDLE_NS    100000	/* writer poll interval when the ring is empty */
+
+/**
+ * struct rts_log_ring - SPSC byte ring between the simulation and writer
+ * @head:   bytes produced (written only by the simulation thread)
+ * @tail:   bytes consumed (written only by the writer thread)
+ * @stop:   set once the producer is done; the writer drains and exits
+ * @buf:    RTS_LOG_RING_SIZE bytes of storage
+ * @fp:     destination stream
+ * @writer: writer thread
+ *
+ * @head and @tail are free-running counters on separate cache lines; the
+ * fill level is head - tail.  The producer publishes bytes with a release
+ * store to @head, the writer returns space with a release store to @tail.
+ */
+struct rts_log_ring {
+	_Alignas(64) atomic_size_t head;
+	_Alignas(64) atomic_size_t tail;
+	_Alignas(64) atomic_int stop;
+	char *buf;
+	FILE *fp;
+	pthread_t writer;
+};
+
+static void rts_log_idle(void) {
+	struct timespec ts = { .tv_sec = 0, .tv_nsec = RTS_LOG_IDLE_NS };
+	nanosleep(&ts, NULL);
+}
+
+static void *rts_log_writer_main(void *arg) {
+	struct rts_log_ring *r = arg;
+	int dirty = 0;
+
+	for (;;) {
+		size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+		size_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+
+		if (head == tail) {
+			if (atomic_load_explicit(&r->stop, memory_order_acquire) &&
+			    atomic_load_explicit(&r->head, memory_order_acquire) == tail)
+				break;
+
+			/* Caught up: push what we have to the terminal, then wait */
+			if (dirty) {
+				fflush(r->fp);
+				dirty = 0;
+			}
+			rts_log_idle();
+			continue;
+		}
+
+		size_t off = tail & (RTS_LOG_RING_SIZE - 1);
+		size_t len = head - tail;
+		if (off + len > RTS_LOG_RING_SIZE)
+			len = RTS_LOG_RING_SIZE - off;
+
+		fwrite(r->buf + off, 1, len, r->fp);
+		dirty = 1;
+
+		atomic_store_explicit(&r->tail, tail + len, memory_order_release);
+	}
+
+	fflush(r->fp);
+	return NULL;
+}
+
+/**
+ * rts_log_ring_write - append @n bytes, waiting only if the ring is full
+ */
+static void rts_log_ring_write(struct rts_log_ring *r, const char *s, size_t n) {
+	size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+
+	while (n > 0) {
+		size_t used = head - atomic_load_explicit(&r->tail, memory_order_acquire);
+		size_t room = RTS_LOG_RING_SIZE - used;
+
+		if (room == 0) {
+			sched_yield();
+			continue;
+		}
+
+		size_t c = n < room ? n : room;
+		size_t off = head & (RTS_LOG_RING_SIZE - 1);
+		size_t first = c < RTS_LOG_RING_SIZE - off ? c : RTS_LOG_RING_SIZE - off;
+
+		memcpy(r->buf + off, s, first);
+		memcpy(r->buf, s + first, c - first);
+
+		head += c;
+		s += c;
+		n -= c;
+		atomic_store_explicit(&r->head, head, memory_order_release);
+	}
+}
+
+int rts_log_level_from_name(const char *name) {
+	if (!name)
+		return -1;
+	if (strcmp(name, "summary") == 0)
+		return RTS_LOG_SUMMARY;
+	if (strcmp(name, "events") == 0)
+		return RTS_LOG_EVENTS;
+	if (strcmp(name, "full") == 0)
+		return RTS_LOG_FULL;
+	return -1;
+}
+
+int rts_log_open(struct rts_log *log, FILE *fp, int level, int async) {
+	log->fp = fp;
+	log->level = level;
+	log->ring = NULL;
+
+	if (!async)
+		return 0;
+
+	struct rts_log_ring *r = aligned_alloc(64, sizeof(*r));
+	char *buf = malloc(RTS_LOG_RING_SIZE);
+	if (!r || !buf) {
+		free(buf);
+		free(r);
+		return -1;
+	}
+
+	atomic_init(&r->head, 0);
+	atomic_init(&r->tail, 0);
+	atomic_init(&r->stop, 0);
+	r->buf = buf;
+	r->fp = fp;
+
+	if (pthread_create(&r->writer, NULL, rts_log_writer_main, r) != 0) {
+		free(buf);
+		free(r);
+		return 0;
+	}
+
+	log->ring = r;
+	return 0;
+}
+
+void rts_log_close(struct rts_log *log) {
+	struct rts_log_ring *r = log->ring;
+
+	if (r) {
+		atomic_store_explicit(&r->stop, 1, memory_order_release);
+		pthread_join(r->writer, NULL);
+		free(r->buf);
+		free(r);
+		log->ring = NULL;
+	}
+
+	if (log->fp)
+		fflush(log->fp);
+}
+
+void rts_log_sync(struct rts_log *log) {
+	struct rts_log_ring *r = log->ring;
+
+	if (!r)
+		return;
+
+	/* The writer has handed a byte to stdio once @tail moves past it */
+	size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+	while (atomic_load_explicit(&r->tail, memory_order_acquire) != head)
+		sched_yield();
+}
+
+void rts_log_printf(struct rts_log *log, const char *fmt, ...) {
+	va_list ap;
+
+	if (!log->ring) {
+		va_start(ap, fmt);
+		vfprintf(log->fp, fmt, ap);
+		va_end(ap);
+		return;
+	}
+
+	char rec[RTS_LOG_REC_MAX];
+	va_start(ap, fmt);
+	int n = vsnprintf(rec, sizeof(rec), fmt, ap);
+	va_end(ap);
+
+	if (n < 0)
+		return;
+
+	if ((size_t)n < sizeof(rec)) {
+		rts_log_ring_write(log->ring, rec, (size_t)n);
+		return;
+	}
+
+	char *big = malloc((size_t)n + 1);
+	if (!big) {
+		rts_log_ring_write(log->ring, rec, sizeof(rec) - 1);
+		return;
+	}
+
+	va_start(ap, fmt);
+	vsnprintf(big, (size_t)n + 1, fmt, ap);
+	va_end(ap);
+
+	rts_log_ring_write(log->ring, big, (size_t)n);
+	free(big);
+}
@@ -3,79 +3,290 @@
  * @file rts_parser.c
  * @brief Task set parser implementation.
  */
+#define _POSIX_C_SOURCE 200809L
+
 #include "rts_parser.h"
 #include "rts_types.h"
 
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * struct parser_buf - contents of a task file
+ * @data:   first byte
+ * @len:    size in bytes
+ * @mapped: @data is a file mapping rather than a malloc'd copy
+ */
+struct parser_buf {
+	const char *data;
+	size_t len;
+	int mapped;
+};
+
+/**
+ * parser_read_all - copy the rest of @fd into memory, for files that
+ * cannot be mapped (pipes, empty or special files)
+ */
+static int parser_read_all(int fd, struct parser_buf *buf) {
+	size_t cap = 4096, len = 0;
+	char *data = malloc(cap);
+
+	if (!data)
+		return -1;
+
+	for (;;) {
+		if (len == cap) {
+			char *tmp = realloc(data, cap * 2);
+
+			if (!tmp) {
+				free(data);
+				return -1;
+			}
+			data = tmp;
+			cap *= 2;
+		}
+
+		ssize_t n = read(fd, data + len, cap - len);
+		if (n < 0) {
+			perror("read task file");
+			free(data);
+			return -1;
+		}
+		if (n == 0)
+			break;
+		len += (size_t)n;
+	}
+
+	buf->data = data;
+	buf->len = len;
+	buf->mapped = 0;
+	return 0;
+}
+
+static int parser_open(const char *path, struct parser_buf *buf) {
+	int fd = open(path, O_RDONLY);
+	struct stat st;
+	int ret = 0;
+
+	if (fd < 0) {
+		perror("open task file");
+		return -1;
+	}
+
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+		void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if (map != MAP_FAILED) {
+			posix_madvise(map, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+			buf->data = map;
+			buf->len = (size_t)st.st_size;
+			buf->mapped = 1;
+			goto out;
+		}
+	}
+
+	ret = parser_read_all(fd, buf);
+out:
+	close(fd);
+	return ret;
+}
+
+static void parser_close(struct parser_buf *buf) {
+	if (buf->mapped)
+		munmap((void *)buf->data, buf->len);
+	else
+		free((void *)buf->data);
+}
+
+/**
+ * parser_add_task - append a task unless its period or wcet is not positive
+ */
+static void parser_add_task(struct rts_task *tasks, int *count,
+                            int phase, int period, int deadline, int wcet) {
+	if (period <= 0 || wcet <= 0)
+		return;
+
+	struct rts_task *t = &tasks[*count];
+
+	t->tid = *count;
+	t->phase = phase;
+	t->period = period;
+	t->rel_deadline = deadline;
+	t->wcet = wcet;
+	t->util = (double)wcet / period;
+	t->release_count = 0;
+	t->preemptions = 0;
+	t->migrations = 0;
+	t->pt_rank = 0;
+	t->pt_threshold = 0;
+	t->next_release = phase;
+	(*count)++;
+}
+
+/* Field separators within a line */
+static inline int parser_is_blank(char c) {
+	return c == ' ' || c == ',' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * parser_int - scan an optionally signed decimal int after any blanks
+ *
+ * Returns the first byte after the number, or NULL if there is none or
+ * it does not fit an int.
+ */
+static const char *parser_int(const char *p, const char *end, int *out) {
+	while (p < end && parser_is_blank(*p))
+		p++;
+
+	int neg = 0;
+	if (p < end && (*p == '-' || *p == '+'))
+		neg = *p++ == '-';
+
+	if (p == end || *p < '0' || *p > '9')
+		return NULL;
+
+	int64_t v = 0;
+	for (; p < end && *p >= '0' && *p <= '9'; p++) {
+		v = v * 10 + (*p - '0');
+		if (v > (int64_t)INT_MAX + 1)
+			return NULL;
+	}
+
+	if (neg)
+		v = -v;
+	if (v > INT_MAX)
+		return NULL;
+
+	*out = (int)v;
+	return p;
+}
 
 /**
- * rts_parser_load_tasks - read task set from text file
+ * parser_load_text - read task set from text
  * Format: phase period deadline wcet
- * 
+ *
  * Task ID (tid) is assigned by the parser in load order
  */
-struct rts_task *rts_parser_load_tasks(const char *path, int *n_tasks_out) {
-	FILE *fp = fopen(path, "r");
-	
-	if (!fp) {
-		perror("open task file");
+static struct rts_task *parser_load_text(const char *data, size_t len, int *n_tasks_out) {
+	const char *end = data + len;
+	size_t lines = 1;
+
+	/* Every task takes a line, so this bounds the array */
+	for (const char *p = data; (p = memchr(p, '\n', (size_t)(end - p))); p++)
+		lines++;
+	if (lines > INT_MAX) {
+		fprintf(stderr, "Error: too many lines in task file\n");
 		return NULL;
 	}
 
-	int cap = 16;
-	struct rts_task *tasks = malloc(sizeof(*tasks) * cap);
+	struct rts_task *tasks = malloc(sizeof(*tasks) * lines);
 	int count = 0;
 
-	if (!tasks) {
-    	fclose(fp);
-    	return NULL;
+	if (!tasks)
+		return NULL;
+
+	for (const char *line = data; line < end;) {
+		const char *eol = memchr(line, '\n', (size_t)(end - line));
+		if (!eol)
+			eol = end;
+
+		int phase, period, deadline, wcet;
+		const char *p = line;
+
+		if (*line != '#' &&
+		    (p = parser_int(p, eol, &phase)) &&
+		    (p = parser_int(p, eol, &period)) &&
+		    (p = parser_int(p, eol, &deadline)) &&
+		    parser_int(p, eol, &wcet))
+			parser_add_task(tasks, &count, phase, period, deadline, wcet);
+
+		line = eol + 1;
 	}
 
-	char line[256];
+	*n_tasks_out = count;
+	return tasks;
+}
 
-	while (fgets(line, sizeof(line), fp)) {
-		if (line[0] == '#' || line[0] == '\n')
-			continue;
+static int32_t parser_get_le32(const unsigned char *p) {
+	return (int32_t)((uint32_t)p[0] | (uint32_t)p[1] << 8 |
+	                 (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24);
+}
 
-		for (char *p = line; *p; ++p) {
-			if (*p == ',') {
-				*p = ' ';
-			}
-		}
+static void parser_put_le32(unsigned char *p, int32_t v) {
+	uint32_t u = (uint32_t)v;
 
-		if (count == cap) {
-        	cap *= 2;
-        	struct rts_task *tmp = realloc(tasks, sizeof(*tasks) * cap);
-        	
-			if (!tmp) {
-            	free(tasks);
-            	fclose(fp);
-            	return NULL;
-        	}
-
-        	tasks = tmp;
-    	}
-		
-		int phase, period, deadline, wcet;
-		if (sscanf(line, "%d %d %d %d",
-				   &phase, &period, &deadline, &wcet) == 4) {
-			
-			if (period <= 0 || wcet <= 0)
-        		continue;
-			
-			tasks[count].tid = count;
-			tasks[count].phase = phase;
-			tasks[count].period = period;
-			tasks[count].rel_deadline = deadline;
-			tasks[count].wcet = wcet;
-			tasks[count].util = (double)wcet / period;
-			count++;
-		}
+	p[0] = (unsigned char)u;
+	p[1] = (unsigned char)(u >> 8);
+	p[2] = (unsigned char)(u >> 16);
+	p[3] = (unsigned char)(u >> 24);
+}
+
+/**
+ * parser_load_binary - read task set from fixed-size records after the magic
+ */
+static struct rts_task *parser_load_binary(const char *data, size_t len, int *n_tasks_out) {
+	size_t body = len - RTS_TASKSET_MAGIC_LEN;
+	size_t n = body / RTS_TASKSET_REC_LEN;
+
+	if (body % RTS_TASKSET_REC_LEN != 0 || n > INT_MAX) {
+		fprintf(stderr, "Error: malformed binary task set\n");
+		return NULL;
 	}
 
-	fclose(fp);
+	struct rts_task *tasks = malloc(sizeof(*tasks) * (n > 0 ? n : 1));
+	int count = 0;
+
+	if (!tasks)
+		return NULL;
+
+	const unsigned char *rec = (const unsigned char *)data + RTS_TASKSET_MAGIC_LEN;
+	for (size_t i = 0; i < n; i++, rec += RTS_TASKSET_REC_LEN)
+		parser_add_task(tasks, &count, parser_get_le32(rec), parser_get_le32(rec + 4),
+		                parser_get_le32(rec + 8), parser_get_le32(rec + 12));
+
 	*n_tasks_out = count;
 	return tasks;
 }
+
+struct rts_task *rts_parser_load_tasks(const char *path, int *n_tasks_out) {
+	struct parser_buf buf;
+
+	if (parser_open(path, &buf) != 0)
+		return NULL;
+
+	struct rts_task *tasks;
+	if (buf.len >= RTS_TASKSET_MAGIC_LEN &&
+	    memcmp(buf.data, RTS_TASKSET_MAGIC, RTS_TASKSET_MAGIC_LEN) == 0)
+		tasks = parser_load_binary(buf.data, buf.len, n_tasks_out);
+	else
+		tasks = parser_load_text(buf.data, buf.len, n_tasks_out);
+
+	parser_close(&buf);
+	return tasks;
+}
+
+int rts_parser_write_binary(FILE *fp, const struct rts_task *tasks, int n_tasks) {
+	char magic[RTS_TASKSET_MAGIC_LEN] = RTS_TASKSET_MAGIC;
+
+	fwrite(magic, 1, sizeof(magic), fp);
+
+	for (int i = 0; i < n_tasks; i++) {
+		const struct rts_task *t = &tasks[i];
+		unsigned char rec[RTS_TASKSET_REC_LEN];
+
+		parser_put_le32(rec, t->phase);
+		parser_put_le32(rec + 4, t->period);
+		parser_put_le32(rec + 8, t->rel_deadline);
+		parser_put_le32(rec + 12, t->wcet);
+		fwrite(rec, 1, sizeof(rec), fp);
+	}
+
+	return ferror(fp) ? -1 : 0;
+}
@@ -6,6 +6,7 @@
 #include "rts_trace.h"
 
 #include <errno.h>
+#include <inttypes.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -34,7 +35,7 @@ static void mkdir_ignore_exists(const char *path) {
     }
 }
 
-static void rts_path_stem(const char *path, char *out, size_t outsz) {
+void rts_trace_stem(const char *path, char *out, size_t outsz) {
 	const char *base;
     const char *s1, *s2, *slash;
 
@@ -63,12 +64,13 @@ static void rts_path_stem(const char *path, char *out, size_t outsz) {
     }
 }
 
-FILE *rts_trace_open(const char *outdir,
-                     const char *task_path,
-                     const char *sched_name,
-                     char *outpath, size_t outpath_sz) {
-	char base[256];
-	rts_path_stem(task_path, base, sizeof(base));
+static FILE *rts_trace_open_path(const char *outdir,
+                                 const char *task_path,
+                                 const char *sched_name,
+                                 const char *ext, const char *mode,
+                                 char *outpath, size_t outpath_sz) {
+	char base[RTS_TRACE_STEM_MAX];
+	rts_trace_stem(task_path, base, sizeof(base));
 
 	char trace_dir[RTS_PATH_MAX];
 	if (outdir && *outdir) {
@@ -82,7 +84,7 @@ FILE *rts_trace_open(const char *outdir,
 
 	const char *sched_tag = (sched_name && *sched_name) ? sched_name : "trace";
 
-	int full_len = snprintf(NULL, 0, "%s%c%s.txt", trace_dir, PATH_SEP, sched_tag) + 1;
+	int full_len = snprintf(NULL, 0, "%s%c%s.%s", trace_dir, PATH_SEP, sched_tag, ext) + 1;
 	if (full_len <= 0)
 		return NULL;
 
@@ -90,13 +92,347 @@ FILE *rts_trace_open(const char *outdir,
 	if (!full)
 		return NULL;
 
-	(void)snprintf(full, (size_t)full_len, "%s%c%s.txt", trace_dir, PATH_SEP, sched_tag);
+	(void)snprintf(full, (size_t)full_len, "%s%c%s.%s", trace_dir, PATH_SEP, sched_tag, ext);
 
 	if (outpath && outpath_sz > 0) {
 		(void)snprintf(outpath, outpath_sz, "%s", full);
 	}
 
-	FILE *fp = fopen(full, "w");
+	FILE *fp = fopen(full, mode);
 	free(full);
 	return fp;
 }
+
+FILE *rts_trace_open(const char *outdir,
+                     const char *task_path,
+                     const char *sched_name,
+                     char *outpath, size_t outpath_sz) {
+	return rts_trace_open_path(outdir, task_path, sched_name, "txt", "w",
+	                           outpath, outpath_sz);
+}
+
+int rts_trace_format_from_name(const char *name) {
+	if (!name)
+		return -1;
+	if (strcmp(name, "tick") == 0)
+		return RTS_TRACE_TICK;
+	if (strcmp(name, "interval") == 0)
+		return RTS_TRACE_INTERVAL;
+	if (strcmp(name, "binary") == 0)
+		return RTS_TRACE_BINARY;
+	return -1;
+}
+
+FILE *rts_trace_open_fmt(const char *outdir,
+                         const char *task_path,
+                         const char *sched_name,
+                         enum rts_trace_format fmt,
+                         char *outpath, size_t outpath_sz) {
+	static const char *const ext[] = {
+		[RTS_TRACE_TICK] = "txt",
+		[RTS_TRACE_INTERVAL] = "itv",
+		[RTS_TRACE_BINARY] = "bin",
+	};
+
+	return rts_trace_open_path(outdir, task_path, sched_name, ext[fmt],
+	                           fmt == RTS_TRACE_BINARY ? "wb" : "w",
+	                           outpath, outpath_sz);
+}
+
+static void rts_trace_put_le(unsigned char *p, uint64_t u, int nbytes) {
+	for (int i = 0; i < nbytes; i++)
+		p[i] = (unsigned char)((u >> (8 * i)) & 0xff);
+}
+
+static uint64_t rts_trace_get_le(const unsigned char *p, int nbytes) {
+	uint64_t u = 0;
+
+	for (int i = 0; i < nbytes; i++)
+		u |= (uint64_t)p[i] << (8 * i);
+	return u;
+}
+
+/* Count what fprintf() reports as written */
+static void rts_trace_count(struct rts_trace *tr, int n) {
+	if (n > 0)
+		tr->bytes += (uint64_t)n;
+}
+
+/* Returns the number of bytes written */
+static uint64_t rts_trace_write_ticks(FILE *fp, int64_t start, int64_t end, int tid, int jid) {
+	uint64_t bytes = 0;
+
+	for (int64_t t = start; t < end; t++) {
+		int n;
+
+		if (tid < 0)
+			n = fprintf(fp, "[%03" PRId64 "] IDLE\n", t);
+		else
+			n = fprintf(fp, "[%03" PRId64 "] T%d:J%d\n", t, tid + 1, jid);
+		if (n > 0)
+			bytes += (uint64_t)n;
+	}
+
+	return bytes;
+}
+
+void rts_trace_init(struct rts_trace *tr, FILE *fp, enum rts_trace_format fmt) {
+	tr->fp = fp;
+	tr->fmt = fmt;
+	tr->pending = 0;
+	tr->bytes = 0;
+
+	if (!fp)
+		return;
+
+	if (fmt == RTS_TRACE_INTERVAL) {
+		rts_trace_count(tr, fprintf(fp, "# start,end,tid,jid\n"));
+	} else if (fmt == RTS_TRACE_BINARY) {
+		char magic[RTS_TRACE_MAGIC_LEN] = RTS_TRACE_MAGIC;
+		tr->bytes += fwrite(magic, 1, sizeof(magic), fp);
+	}
+}
+
+void rts_trace_flush(struct rts_trace *tr) {
+	if (!tr->pending || !tr->fp)
+		return;
+
+	int tid = tr->tid < 0 ? 0 : tr->tid + 1;
+	int jid = tr->tid < 0 ? 0 : tr->jid;
+
+	if (tr->fmt == RTS_TRACE_INTERVAL) {
+		rts_trace_count(tr, fprintf(tr->fp, "%" PRId64 ",%" PRId64 ",%d,%d\n",
+		                            tr->start, tr->end, tid, jid));
+	} else {
+		unsigned char rec[RTS_TRACE_REC_LEN];
+
+		rts_trace_put_le(rec, (uint64_t)tr->start, 8);
+		rts_trace_put_le(rec + 8, (uint64_t)tr->end, 8);
+		rts_trace_put_le(rec + 16, (uint32_t)tid, 4);
+		rts_trace_put_le(rec + 20, (uint32_t)jid, 4);
+		tr->bytes += fwrite(rec, 1, sizeof(rec), tr->fp);
+	}
+
+	tr->pending = 0;
+}
+
+void rts_trace_emit(struct rts_trace *tr, int64_t start, int64_t end, int tid, int jid) {
+	if (!tr->fp)
+		return;
+
+	if (tr->fmt == RTS_TRACE_TICK) {
+		tr->bytes += rts_trace_write_ticks(tr->fp, start, end, tid, jid);
+		return;
+	}
+
+	if (tr->pending && tr->end == start && tr->tid == tid &&
+	    (tid < 0 || tr->jid == jid)) {
+		tr->end = end;
+		return;
+	}
+
+	rts_trace_flush(tr);
+
+	tr->pending = 1;
+	tr->start = start;
+	tr->end = end;
+	tr->tid = tid;
+	tr->jid = jid;
+}
+
+void rts_trace_close(struct rts_trace *tr) {
+	rts_trace_flush(tr);
+
+	if (tr->fp)
+		fclose(tr->fp);
+	tr->fp = NULL;
+}
+
+int rts_trace_to_ticks(FILE *in, FILE *out) {
+	unsigned char buf[RTS_TRACE_REC_LEN];
+	size_t n = fread(buf, 1, RTS_TRACE_MAGIC_LEN, in);
+
+	/* Binary: magic followed by fixed-size records */
+	if (n == RTS_TRACE_MAGIC_LEN && memcmp(buf, RTS_TRACE_MAGIC, RTS_TRACE_MAGIC_LEN) == 0) {
+		while ((n = fread(buf, 1, sizeof(buf), in)) == sizeof(buf)) {
+			int64_t start = (int64_t)rts_trace_get_le(buf, 8);
+			int64_t end = (int64_t)rts_trace_get_le(buf + 8, 8);
+
+			if (end < start)
+				return -1;
+			rts_trace_write_ticks(out, start, end, (int32_t)rts_trace_get_le(buf + 16, 4) - 1,
+			                      (int32_t)rts_trace_get_le(buf + 20, 4));
+		}
+		return n == 0 ? 0 : -1;
+	}
+
+	/* Interval text: re-read from the start */
+	if (fseek(in, 0, SEEK_SET) != 0)
+		return -1;
+
+	char line[128];
+	while (fgets(line, sizeof(line), in)) {
+		int64_t start, end;
+		int tid, jid;
+
+		if (line[0] == '#' || line[0] == '\n')
+			continue;
+		if (sscanf(line, "%" SCNd64 ",%" SCNd64 ",%d,%d", &start, &end, &tid, &jid) != 4 ||
+		    end < start)
+			return -1;
+
+		rts_trace_write_ticks(out, start, end, tid - 1, jid);
+	}
+
+	return 0;
+}
+
+/**
+ * struct rts_trace_seg - one interval read back from a per-CPU trace
+ * @tid: 1-based task id (0: IDLE)
+ */
+struct rts_trace_seg {
+	int64_t start;
+	int64_t end;
+	int tid;
+	int jid;
+};
+
+/**
+ * rts_trace_read_segs - load an interval trace, mapping its task ids
+ *
+ * Returns 0 and a malloc'd array (possibly NULL when empty), or -1.
+ */
+static int rts_trace_read_segs(FILE *in, const int *tid_map,
+                               struct rts_trace_seg **segs_out, int *n_out) {
+	struct rts_trace_seg *segs = NULL;
+	int n = 0, cap = 0;
+	char line[128];
+
+	*segs_out = NULL;
+	*n_out = 0;
+	if (!in)
+		return 0;
+
+	rewind(in);
+	while (fgets(line, sizeof(line), in)) {
+		int64_t start, end;
+		int tid, jid;
+
+		if (line[0] == '#' || line[0] == '\n')
+			continue;
+		if (sscanf(line, "%" SCNd64 ",%" SCNd64 ",%d,%d", &start, &end, &tid, &jid) != 4 ||
+		    end < start || tid < 0)
+			goto fail;
+
+		if (n == cap) {
+			cap = cap ? cap * 2 : 64;
+			struct rts_trace_seg *tmp = realloc(segs, sizeof(*tmp) * (size_t)cap);
+			if (!tmp)
+				goto fail;
+			segs = tmp;
+		}
+
+		segs[n++] = (struct rts_trace_seg){
+		    .start = start,
+		    .end = end,
+		    .tid = (tid && tid_map) ? tid_map[tid - 1] + 1 : tid,
+		    .jid = jid,
+		};
+	}
+
+	*segs_out = segs;
+	*n_out = n;
+	return 0;
+
+fail:
+	free(segs);
+	return -1;
+}
+
+static void rts_trace_merge_ticks(FILE *out, FILE *const *in,
+                                  struct rts_trace_seg **segs, const int *n_segs,
+                                  int *pos, int n) {
+	int64_t end = 0;
+
+	for (int c = 0; c < n; c++) {
+		if (n_segs[c] > 0 && segs[c][n_segs[c] - 1].end > end)
+			end = segs[c][n_segs[c] - 1].end;
+	}
+
+	for (int64_t t = 0; t < end; t++) {
+		fprintf(out, "[%03" PRId64 "]", t);
+
+		for (int c = 0; c < n; c++) {
+			while (pos[c] < n_segs[c] && segs[c][pos[c]].end <= t)
+				pos[c]++;
+
+			fputs(c ? " | " : " ", out);
+			if (!in[c]) {
+				fputs("IDLE", out);
+			} else if (pos[c] < n_segs[c] && segs[c][pos[c]].start <= t) {
+				const struct rts_trace_seg *s = &segs[c][pos[c]];
+
+				if (s->tid)
+					fprintf(out, "T%d:J%d", s->tid, s->jid);
+				else
+					fputs("IDLE", out);
+			} else {
+				fputs("-", out);
+			}
+		}
+		fputc('\n', out);
+	}
+}
+
+static void rts_trace_merge_intervals(FILE *out, struct rts_trace_seg **segs,
+                                      const int *n_segs, int *pos, int n) {
+	fprintf(out, "# cpu,start,end,tid,jid\n");
+
+	for (;;) {
+		int best = -1;
+
+		for (int c = 0; c < n; c++) {
+			if (pos[c] < n_segs[c] &&
+			    (best < 0 || segs[c][pos[c]].start < segs[best][pos[best]].start))
+				best = c;
+		}
+		if (best < 0)
+			break;
+
+		const struct rts_trace_seg *s = &segs[best][pos[best]++];
+		fprintf(out, "%d,%" PRId64 ",%" PRId64 ",%d,%d\n",
+		        best, s->start, s->end, s->tid, s->jid);
+	}
+}
+
+int rts_trace_merge(FILE *const *in, const int *const *tid_map, int n,
+                    FILE *out, enum rts_trace_format fmt) {
+	struct rts_trace_seg **segs = calloc((size_t)(n > 0 ? n : 1), sizeof(*segs));
+	int *n_segs = calloc((size_t)(n > 0 ? n : 1), sizeof(*n_segs));
+	int *pos = calloc((size_t)(n > 0 ? n : 1), sizeof(*pos));
+	int ret = -1;
+
+	if (!segs || !n_segs || !pos)
+		goto out;
+
+	for (int c = 0; c < n; c++) {
+		if (rts_trace_read_segs(in[c], tid_map ? tid_map[c] : NULL,
+		                        &segs[c], &n_segs[c]) != 0)
+			goto out;
+	}
+
+	if (fmt == RTS_TRACE_INTERVAL)
+		rts_trace_merge_intervals(out, segs, n_segs, pos, n);
+	else
+		rts_trace_merge_ticks(out, in, segs, n_segs, pos, n);
+	ret = 0;
+
+out:
+	for (int c = 0; segs && c < n; c++)
+		free(segs[c]);
+	free(pos);
+	free(n_segs);
+	free(segs);
+	return ret;
+}
@@ -5,25 +5,34 @@
  */
 #include "rts_util.h"
 
-int rts_util_gcd(int a, int b) {
+int64_t rts_util_gcd(int64_t a, int64_t b) {
 	while (b != 0) {
-		int t = b;
+		int64_t t = b;
 		b = a % b;
 		a = t;
 	}
 	return a;
 }
 
-int rts_util_lcm(int a, int b) {
-	return (a * b) / rts_util_gcd(a, b);
+int rts_util_lcm(int64_t a, int64_t b, int64_t *lcm) {
+	int64_t q = a / rts_util_gcd(a, b);
+
+	/* q * b must not overflow: divide first, then check the product */
+	if (b != 0 && q > INT64_MAX / b)
+		return -1;
+
+	*lcm = q * b;
+	return 0;
 }
 
-int rts_util_hyperperiod(const int *periods, int n) {
-	int result = periods[0];
+int rts_util_hyperperiod(const int *periods, int n, int64_t *hp) {
+	int64_t result = periods[0];
 
 	for (int i = 1; i < n; i++) {
-		result = rts_util_lcm(result, periods[i]);
+		if (rts_util_lcm(result, periods[i], &result) != 0)
+			return -1;
 	}
 
-	return result;
+	*hp = result;
+	return 0;
 }